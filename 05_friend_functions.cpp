@@ -1,4 +1,20 @@
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 /*
     ===========================================
@@ -62,6 +78,9 @@ private:
 
     int data;
 
+    // Private fields listed for FieldAccess (see the field visitor example)
+    static constexpr std::tuple Fields{ &MyClass::data };
+
 public:
 
     MyClass(int d) : data(d) 
@@ -69,6 +88,8 @@ public:
 
     // Declaration of friend function
     friend void DisplayData(const MyClass& obj);
+
+    friend struct FieldAccess;
 };
 
 // Definition of friend function
@@ -113,11 +134,15 @@ class SampleClass
 private:
     int value;
 
+    static constexpr std::tuple Fields{ &SampleClass::value };
+
 public:
     SampleClass(int v) : value(v) {}
 
     // Declaration of friend class
     friend class FriendClass;
+
+    friend struct FieldAccess;
 };
 
 class FriendClass
@@ -199,6 +224,548 @@ void RunSample3()
     c2.Display();
 }
 
+// ==================================================
+//    Example : Exchange between threads
+// ==================================================
+
+/*
+    Exchange() above reads and writes plain ints. If another thread calls 
+    SetData() or Exchange() on the same objects at the same time, values can be
+    lost or duplicated.
+
+    SwapCell<T> holds a value that can be exchanged with another cell safely:
+
+    - Small values (up to 4 bytes, e.g. int) are packed into one 64-bit atomic 
+      word together with a lock bit. Exchange sets the lock bit of both cells 
+      with compare-and-swap, always in address order so two exchanges can never 
+      wait on each other, then writes the swapped values and clears the bits in 
+      the same store. Readers only wait while a swap is in flight.
+
+    - Larger values (e.g. std::string) fall back to a fixed table of striped 
+      mutexes chosen by address, again locked in address order.
+
+    Snapshot() reads two cells as one consistent pair.
+*/
+
+// Mutexes shared by all striped cells, chosen by address
+inline std::mutex& StripeFor(const void* p)
+{
+    static std::mutex stripes[64];
+    return stripes[(reinterpret_cast<std::uintptr_t>(p) >> 6) % 64];
+}
+
+template <typename T>
+class PackedCell
+{
+private:
+
+    static constexpr std::uint64_t LockBit = std::uint64_t(1) << 32;
+
+    std::atomic<std::uint64_t> word{0};
+
+    static std::uint64_t Encode(const T& value)
+    {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        return bits;
+    }
+
+    static T Decode(std::uint64_t w)
+    {
+        std::uint32_t bits = (std::uint32_t)w;
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+
+    // Sets the lock bit and returns the value it protected
+    T Lock()
+    {
+        for (;;)
+        {
+            std::uint64_t w = word.load(std::memory_order_relaxed);
+            if (!(w & LockBit) && word.compare_exchange_weak(w, w | LockBit, std::memory_order_acquire))
+                return Decode(w);
+            std::this_thread::yield();
+        }
+    }
+
+    void Unlock(const T& value)
+    {
+        word.store(Encode(value), std::memory_order_release);
+    }
+
+public:
+
+    PackedCell(const T& value = T()) : word(Encode(value)) {}
+
+    T Load() const
+    {
+        for (;;)
+        {
+            std::uint64_t w = word.load(std::memory_order_acquire);
+            if (!(w & LockBit))
+                return Decode(w);
+            std::this_thread::yield();
+        }
+    }
+
+    void Store(const T& value)
+    {
+        Lock();
+        Unlock(value);
+    }
+
+    static void Exchange(PackedCell& a, PackedCell& b)
+    {
+        if (&a == &b)
+            return;
+        PackedCell& first = std::less<PackedCell*>()(&a, &b) ? a : b;
+        PackedCell& second = (&first == &a) ? b : a;
+
+        T x = first.Lock();
+        T y = second.Lock();
+        first.Unlock(y);
+        second.Unlock(x);
+    }
+
+    friend std::pair<T, T> Snapshot(PackedCell& a, PackedCell& b)
+    {
+        if (&a == &b)
+            return { a.Load(), a.Load() };
+        PackedCell& first = std::less<PackedCell*>()(&a, &b) ? a : b;
+        PackedCell& second = (&first == &a) ? b : a;
+
+        T x = first.Lock();
+        T y = second.Lock();
+        first.Unlock(x);
+        second.Unlock(y);
+        return (&first == &a) ? std::pair<T, T>{ x, y } : std::pair<T, T>{ y, x };
+    }
+};
+
+template <typename T>
+class StripedCell
+{
+private:
+
+    T value;
+
+public:
+
+    StripedCell(const T& v = T()) : value(v) {}
+
+    T Load() const
+    {
+        std::lock_guard<std::mutex> guard(StripeFor(this));
+        return value;
+    }
+
+    void Store(const T& v)
+    {
+        std::lock_guard<std::mutex> guard(StripeFor(this));
+        value = v;
+    }
+
+    static void Exchange(StripedCell& a, StripedCell& b)
+    {
+        std::mutex& ma = StripeFor(&a);
+        std::mutex& mb = StripeFor(&b);
+        if (&ma == &mb)
+        {
+            std::lock_guard<std::mutex> guard(ma);
+            std::swap(a.value, b.value);
+            return;
+        }
+        std::scoped_lock guard(ma, mb);     // deadlock-free for two mutexes
+        std::swap(a.value, b.value);
+    }
+
+    friend std::pair<T, T> Snapshot(StripedCell& a, StripedCell& b)
+    {
+        std::mutex& ma = StripeFor(&a);
+        std::mutex& mb = StripeFor(&b);
+        if (&ma == &mb)
+        {
+            std::lock_guard<std::mutex> guard(ma);
+            return { a.value, b.value };
+        }
+        std::scoped_lock guard(ma, mb);
+        return { a.value, b.value };
+    }
+};
+
+template <typename T>
+using SwapCell = std::conditional_t<std::is_trivially_copyable_v<T> && sizeof(T) <= 4, 
+                                    PackedCell<T>, StripedCell<T>>;
+
+// Same friend pattern as Class1/Class2, with values that threads can share
+class SharedClass2;
+
+class SharedClass1
+{
+private:
+
+    SwapCell<int> value1;
+
+public:
+
+    void SetData(int val) { value1.Store(val); }
+    int GetData() const { return value1.Load(); }
+    friend void Exchange(SharedClass1&, SharedClass2&);
+    friend std::pair<int, int> Snapshot(SharedClass1&, SharedClass2&);
+};
+
+class SharedClass2
+{
+private:
+
+    SwapCell<int> value2;
+
+public:
+
+    void SetData(int val) { value2.Store(val); }
+    int GetData() const { return value2.Load(); }
+    friend void Exchange(SharedClass1&, SharedClass2&);
+    friend std::pair<int, int> Snapshot(SharedClass1&, SharedClass2&);
+};
+
+void Exchange(SharedClass1& x, SharedClass2& y)
+{
+    SwapCell<int>::Exchange(x.value1, y.value2);
+}
+
+std::pair<int, int> Snapshot(SharedClass1& x, SharedClass2& y)
+{
+    return Snapshot(x.value1, y.value2);
+}
+
+// Random exchanges between `cells` from several threads; returns exchanges/s
+template <typename Cell>
+double RunExchanges(std::vector<Cell>& cells, int threads, int perThread)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&cells, perThread, t]
+        {
+            std::minstd_rand rng(t + 1);
+            for (int i = 0; i < perThread; i++)
+                Cell::Exchange(cells[rng() % cells.size()], cells[rng() % cells.size()]);
+        });
+    }
+    for (std::thread& w : workers)
+        w.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * (double)perThread / elapsed.count();
+}
+
+// Exchanges only move values around, so the sorted values never change
+template <typename Cell>
+bool ValuesPreserved(const std::vector<Cell>& cells, int count)
+{
+    std::vector<int> values;
+    for (const Cell& cell : cells)
+        values.push_back(cell.Load());
+    std::sort(values.begin(), values.end());
+    for (int i = 0; i < count; i++)
+        if (values[i] != i)
+            return false;
+    return true;
+}
+
+void RunSample4()
+{
+    SharedClass1 c1;
+    SharedClass2 c2;
+    c1.SetData(100);
+    c2.SetData(200);
+    Exchange(c1, c2);
+    std::cout << "After exchange: " << c1.GetData() << " " << c2.GetData() << std::endl;
+
+    // Strings use the striped lock fallback
+    SwapCell<std::string> s1(std::string("left")), s2(std::string("right"));
+    SwapCell<std::string>::Exchange(s1, s2);
+    std::cout << "Strings: " << s1.Load() << " " << s2.Load() << std::endl;
+
+    // Stress test: exchanges plus a reader checking pairs stay distinct
+    const int cellCount = 64;
+    std::vector<PackedCell<int>> cells(cellCount);
+    for (int i = 0; i < cellCount; i++)
+        cells[i].Store(i);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::thread reader([&]
+    {
+        while (!done)
+        {
+            auto [a, b] = Snapshot(cells[0], cells[1]);
+            if (a == b)
+                torn++;
+        }
+    });
+    RunExchanges(cells, 8, 100000);
+    done = true;
+    reader.join();
+
+    std::cout << "Stress test: values " << (ValuesPreserved(cells, cellCount) ? "preserved" : "CORRUPTED")
+              << ", inconsistent snapshots " << torn << std::endl;
+
+    // Throughput: packed CAS cells vs striped locks
+    std::vector<StripedCell<int>> striped(cellCount);
+    for (int i = 0; i < cellCount; i++)
+        striped[i].Store(i);
+
+    std::cout << "Threads  packed (M/s)  striped (M/s)" << std::endl;
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+        double packedRate = RunExchanges(cells, threads, 200000);
+        double stripedRate = RunExchanges(striped, threads, 200000);
+        std::cout << threads << "\t " << packedRate / 1e6 << "\t\t" << stripedRate / 1e6 << std::endl;
+    }
+    std::cout << "Striped values " << (ValuesPreserved(striped, cellCount) ? "preserved" : "CORRUPTED") << std::endl;
+}
+
+// ==================================================
+//    Example : Friend-based field visitor
+// ==================================================
+
+/*
+    Hashing, comparing or saving an object needs every private member, which is
+    usually written by hand for each class (and forgotten when a member is 
+    added). Instead a class can grant one friend, FieldAccess, and list its 
+    members once as a private tuple of member pointers:
+
+    private:
+        static constexpr std::tuple Fields{ &MyClass::data };
+    public:
+        friend struct FieldAccess;
+
+    Fields is private too, so only FieldAccess can use the member pointers.
+
+    FieldAccess::ForEach then visits the members at compile time, and the 
+    generic functions below are built on it for any such class:
+    - FieldHash  : wyhash-style hash (multiply-and-fold mixing of every field)
+    - FieldEqual : member-wise equality
+    - Serialize / Deserialize : packed binary form; numbers as raw bytes, 
+      strings as a 32-bit length followed by the characters
+*/
+
+struct FieldAccess
+{
+    template <typename T>
+    static constexpr bool Visitable = requires { std::remove_cvref_t<T>::Fields; };
+
+    // f(member) for every listed member of obj
+    template <typename T, typename F>
+    static void ForEach(T& obj, F&& f)
+    {
+        std::apply([&](auto... member) { (f(obj.*member), ...); }, std::remove_cvref_t<T>::Fields);
+    }
+
+    // f(member of a, same member of b); stops at the first `false`
+    template <typename T, typename F>
+    static bool All(const T& a, const T& b, F&& f)
+    {
+        return std::apply([&](auto... member) { return (f(a.*member, b.*member) && ...); }, T::Fields);
+    }
+};
+
+template <typename T>
+concept Visitable = FieldAccess::Visitable<T>;
+
+// 64 x 64 -> 128 bit multiply, folded back to 64 bits
+inline std::uint64_t WyMix(std::uint64_t a, std::uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return (std::uint64_t)r ^ (std::uint64_t)(r >> 64);
+#else
+    std::uint64_t ha = a >> 32, la = (std::uint32_t)a, hb = b >> 32, lb = (std::uint32_t)b;
+    std::uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+    std::uint64_t mid = (ll >> 32) + (std::uint32_t)hl + (std::uint32_t)lh;
+    return (hh + (hl >> 32) + (lh >> 32) + (mid >> 32)) ^ ((mid << 32) | (std::uint32_t)ll);
+#endif
+}
+
+constexpr std::uint64_t WyP0 = 0xa0761d6478bd642full;
+constexpr std::uint64_t WyP1 = 0xe7037ed1a0b428dbull;
+
+template <Visitable T>
+struct FieldHash
+{
+    std::size_t operator()(const T& obj) const
+    {
+        std::uint64_t h = WyP0;
+        FieldAccess::ForEach(obj, [&](const auto& field)
+        {
+            using F = std::remove_cvref_t<decltype(field)>;
+            if constexpr (std::is_same_v<F, std::string>)
+            {
+                // 8 bytes at a time, then the tail and the length
+                std::size_t i = 0;
+                for (; i + 8 <= field.size(); i += 8)
+                {
+                    std::uint64_t chunk;
+                    std::memcpy(&chunk, field.data() + i, 8);
+                    h = WyMix(h ^ chunk, WyP1);
+                }
+                std::uint64_t tail = 0;
+                std::memcpy(&tail, field.data() + i, field.size() - i);
+                h = WyMix(h ^ tail ^ field.size(), WyP1);
+            }
+            else
+            {
+                static_assert(std::is_arithmetic_v<F>, "FieldHash: unsupported field type");
+                static_assert(sizeof(F) <= sizeof(std::uint64_t), "FieldHash: fields wider than 64 bits (long double) are not supported");
+
+                // -0.0 == 0.0 for FieldEqual, so both must hash the same
+                F value = field;
+                if constexpr (std::is_floating_point_v<F>)
+                    if (value == 0)
+                        value = 0;
+
+                std::uint64_t bits = 0;
+                std::memcpy(&bits, &value, sizeof(F));
+                h = WyMix(h ^ bits, WyP1);
+            }
+        });
+        return (std::size_t)WyMix(h, WyP0);
+    }
+};
+
+template <Visitable T>
+struct FieldEqual
+{
+    bool operator()(const T& a, const T& b) const
+    {
+        return FieldAccess::All(a, b, [](const auto& x, const auto& y) { return x == y; });
+    }
+};
+
+template <Visitable T>
+void Serialize(const T& obj, std::vector<std::byte>& out)
+{
+    auto append = [&](const void* p, std::size_t n)
+    {
+        const std::byte* bytes = static_cast<const std::byte*>(p);
+        out.insert(out.end(), bytes, bytes + n);
+    };
+
+    FieldAccess::ForEach(obj, [&](const auto& field)
+    {
+        using F = std::remove_cvref_t<decltype(field)>;
+        if constexpr (std::is_same_v<F, std::string>)
+        {
+            std::uint32_t length = (std::uint32_t)field.size();
+            append(&length, sizeof(length));
+            append(field.data(), field.size());
+        }
+        else
+        {
+            static_assert(std::is_arithmetic_v<F>, "Serialize: unsupported field type");
+            append(&field, sizeof(F));
+        }
+    });
+}
+
+// Reads one object from the front of `in` and advances it; false if too short.
+// The fields are decoded into a default-constructed T first, so on failure
+// `obj` and `in` are left unchanged
+template <Visitable T>
+bool Deserialize(T& obj, std::span<const std::byte>& in)
+{
+    T decoded{};
+    std::span<const std::byte> rest = in;
+    bool ok = true;
+    auto take = [&](void* p, std::size_t n)
+    {
+        if (!ok || rest.size() < n)
+        {
+            ok = false;
+            return;
+        }
+        std::memcpy(p, rest.data(), n);
+        rest = rest.subspan(n);
+    };
+
+    FieldAccess::ForEach(decoded, [&](auto& field)
+    {
+        using F = std::remove_cvref_t<decltype(field)>;
+        if constexpr (std::is_same_v<F, std::string>)
+        {
+            std::uint32_t length = 0;
+            take(&length, sizeof(length));
+            if (!ok || rest.size() < length)
+            {
+                ok = false;
+                return;
+            }
+            field.assign(reinterpret_cast<const char*>(rest.data()), length);
+            rest = rest.subspan(length);
+        }
+        else
+        {
+            take(&field, sizeof(F));
+        }
+    });
+
+    if (!ok)
+        return false;
+
+    obj = std::move(decoded);
+    in = rest;
+    return true;
+}
+
+// A class with several kinds of private members
+class Employee
+{
+private:
+
+    int id = 0;
+    double salary = 0;
+    std::string name;
+
+    static constexpr std::tuple Fields{ &Employee::id, &Employee::salary, &Employee::name };
+
+public:
+
+    Employee() {}
+    Employee(int i, double s, std::string n) : id(i), salary(s), name(std::move(n)) {}
+
+    void Display() const { std::cout << id << " " << name << " " << salary << std::endl; }
+
+    friend struct FieldAccess;
+};
+
+void RunSample5()
+{
+    // Hash index of objects with only private members
+    std::unordered_set<Employee, FieldHash<Employee>, FieldEqual<Employee>> staff;
+    staff.insert(Employee(1, 5000.0, "Asha"));
+    staff.insert(Employee(2, 6200.5, "Ravi"));
+    staff.insert(Employee(1, 5000.0, "Asha"));     // duplicate, ignored
+    std::cout << "Unique employees: " << staff.size() << std::endl;
+
+    std::cout << "MyClass(42) == MyClass(42): " << FieldEqual<MyClass>()(MyClass(42), MyClass(42)) << std::endl;
+    std::cout << "Hash of SampleClass(100): " << FieldHash<SampleClass>()(SampleClass(100)) << std::endl;
+
+    // Snapshot and restore
+    std::vector<std::byte> snapshot;
+    for (const Employee& e : staff)
+        Serialize(e, snapshot);
+    std::cout << "Snapshot bytes: " << snapshot.size() << std::endl;
+
+    std::span<const std::byte> in(snapshot);
+    Employee restored;
+    while (Deserialize(restored, in))
+        restored.Display();
+}
+
 int main() 
 {
     std::cout << ">> Run Sample 1" << std::endl;
@@ -209,5 +776,11 @@ int main()
 
     std::cout << ">> Run Sample 3" << std::endl;
     RunSample3();
+
+    std::cout << ">> Run Sample 4" << std::endl;
+    RunSample4();
+
+    std::cout << ">> Run Sample 5" << std::endl;
+    RunSample5();
     return 0;
 }
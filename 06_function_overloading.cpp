@@ -1,4 +1,22 @@
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 /*
     ===========================================
@@ -66,15 +84,140 @@
 
 */
 
+// ===========================================
+//            Print output buffer
+// ===========================================
+
+/*
+    `std::cout << x << std::endl` formats through the iostream machinery and 
+    `std::endl` flushes the stream on every line, i.e. one system call per 
+    number.
+
+    The print overloads instead format with std::to_chars straight into a large 
+    per-thread buffer, and the buffer is written out in one piece when it fills 
+    up, when FlushPrint() is called, or when the thread exits. For double, 
+    to_chars without a precision produces the shortest text that reads back to 
+    exactly the same value.
+
+    Because output is delayed, call FlushPrint() before mixing print() with 
+    std::cout so the lines come out in order.
+*/
+
+class PrintBuffer
+{
+private:
+
+    static constexpr std::size_t Capacity = 1 << 16;
+
+    char data[Capacity];
+    std::size_t used = 0;
+    std::FILE* sink = stdout;
+
+public:
+
+    ~PrintBuffer()
+    {
+        Flush();
+    }
+
+    static PrintBuffer& Local()
+    {
+        thread_local PrintBuffer buffer;
+        return buffer;
+    }
+
+    void SetSink(std::FILE* file)
+    {
+        Flush();
+        sink = file;
+    }
+
+    void Flush()
+    {
+        if (used > 0)
+            std::fwrite(data, 1, used, sink);
+        used = 0;
+    }
+
+    void Append(std::string_view text)
+    {
+        if (Capacity - used < text.size())
+        {
+            Flush();
+            if (text.size() > Capacity)
+            {
+                std::fwrite(text.data(), 1, text.size(), sink);
+                return;
+            }
+        }
+        std::copy(text.begin(), text.end(), data + used);
+        used += text.size();
+    }
+
+    void Append(char c)
+    {
+        if (used == Capacity)
+            Flush();
+        data[used++] = c;
+    }
+
+    // Enough room for any int or shortest round-trip double
+    template <typename T>
+    void AppendNumber(T value)
+    {
+        constexpr std::size_t MaxLength = 32;
+        if (Capacity - used < MaxLength)
+            Flush();
+        std::to_chars_result result = std::to_chars(data + used, data + used + MaxLength, value);
+        used = result.ptr - data;
+    }
+};
+
+void FlushPrint()
+{
+    PrintBuffer::Local().Flush();
+}
+
 // Function overloading with different parameter lists
 void print(int x) 
 {
-    std::cout << "Integer: " << x << std::endl;
+    PrintBuffer& out = PrintBuffer::Local();
+    out.Append("Integer: ");
+    out.AppendNumber(x);
+    out.Append('\n');
 }
 
 void print(double x) 
 {
-    std::cout << "Double: " << x << std::endl;
+    PrintBuffer& out = PrintBuffer::Local();
+    out.Append("Double: ");
+    out.AppendNumber(x);
+    out.Append('\n');
+}
+
+// Batched overloads: all values on one line, separated by spaces
+void print(std::span<const int> values)
+{
+    PrintBuffer& out = PrintBuffer::Local();
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        if (i > 0)
+            out.Append(' ');
+        out.AppendNumber(values[i]);
+    }
+    out.Append('\n');
+}
+
+void print(std::span<const double> values)
+{
+    PrintBuffer& out = PrintBuffer::Local();
+    for (std::size_t i = 0; i < values.size(); i++)
+    {
+        if (i > 0)
+            out.Append(' ');
+        out.AppendNumber(values[i]);
+    }
+    out.Append('\n');
 }
 
 // Overloaded functions with different number of parameters
@@ -88,6 +231,323 @@ int sum(int a, int b, int c)
     return a + b + c;
 }
 
+// Variadic overload for any number of arithmetic arguments, using a fold 
+// expression. The fixed overloads above are still preferred for 2 and 3 ints, 
+// as a non-template exact match beats a template.
+template <typename... Ts>
+    requires (sizeof...(Ts) > 0 && (std::is_arithmetic_v<Ts> && ...))
+constexpr auto sum(Ts... args)
+{
+    return (args + ...);
+}
+
+static_assert(sum(1, 2, 3, 4) == 10);
+static_assert(sum(1, 2.5) == 3.5);
+
+// ===========================================
+//        Summing arrays (span overloads)
+// ===========================================
+
+/*
+    Summing a large array one element at a time is slow, because every addition
+    waits for the previous one, and for floating point it is also inaccurate,
+    because small values get lost once the running total is large.
+
+    SumMode picks the trade-off:
+    - Fast     : 8 independent accumulators, so the additions overlap and the 
+                 compiler can keep them in SIMD registers.
+    - Kahan    : compensated summation; carries the rounding error of every 
+                 addition forward. Most accurate, slowest.
+    - Pairwise : sums fixed-size blocks, then adds the block totals as a 
+                 balanced tree. Error grows with log(n) instead of n, at close 
+                 to Fast speed.
+    - Parallel : Pairwise blocks summed on all cores. Blocks have a fixed size 
+                 and are combined in a fixed order, so the result is the same 
+                 on every run and for any number of threads.
+
+    Integers accumulate in `long long`; only Fast and Parallel differ for them.
+*/
+
+enum class SumMode { Fast, Kahan, Pairwise, Parallel };
+
+template <typename T>
+using SumResult = std::conditional_t<std::is_integral_v<T>, long long, T>;
+
+template <typename T>
+SumResult<T> SumFast(std::span<const T> values)
+{
+    using R = SumResult<T>;
+    constexpr std::size_t Lanes = 8;
+
+    R acc[Lanes] = {};
+    const std::size_t full = values.size() - values.size() % Lanes;
+    for (std::size_t i = 0; i < full; i += Lanes)
+        for (std::size_t j = 0; j < Lanes; j++)
+            acc[j] += values[i + j];
+
+    R total = 0;
+    for (std::size_t i = full; i < values.size(); i++)
+        total += values[i];
+
+    // Combine the lanes as a small tree as well
+    for (std::size_t width = Lanes / 2; width > 0; width /= 2)
+        for (std::size_t j = 0; j < width; j++)
+            acc[j] += acc[j + width];
+    return total + acc[0];
+}
+
+template <typename T>
+SumResult<T> SumKahan(std::span<const T> values)
+{
+    // Neumaier's variant, which also handles terms larger than the total
+    SumResult<T> total = 0, compensation = 0;
+    for (T v : values)
+    {
+        SumResult<T> t = total + v;
+        if ((total < 0 ? -total : total) >= (v < 0 ? -v : v))
+            compensation += (total - t) + v;
+        else
+            compensation += (v - t) + total;
+        total = t;
+    }
+    return total + compensation;
+}
+
+constexpr std::size_t SumBlockSize = 1024;
+
+// Adds partial totals as a balanced tree
+template <typename R>
+R SumTree(std::span<const R> partials)
+{
+    if (partials.size() <= 2)
+        return partials.empty() ? R(0) : (partials.size() == 1 ? partials[0] : partials[0] + partials[1]);
+
+    std::size_t half = partials.size() / 2;
+    return SumTree(partials.first(half)) + SumTree(partials.subspan(half));
+}
+
+template <typename T>
+std::vector<SumResult<T>> SumBlocks(std::span<const T> values, unsigned threads)
+{
+    const std::size_t blocks = (values.size() + SumBlockSize - 1) / SumBlockSize;
+    std::vector<SumResult<T>> partials(blocks);
+
+    auto work = [&](std::size_t first, std::size_t last)
+    {
+        for (std::size_t b = first; b < last; b++)
+        {
+            std::size_t begin = b * SumBlockSize;
+            partials[b] = SumFast(values.subspan(begin, std::min(SumBlockSize, values.size() - begin)));
+        }
+    };
+
+    std::vector<std::thread> workers;
+    std::size_t perThread = (blocks + threads - 1) / threads;
+    for (unsigned t = 1; t < threads && t * perThread < blocks; t++)
+        workers.emplace_back(work, t * perThread, std::min(blocks, (t + 1) * perThread));
+    work(0, std::min(blocks, perThread));
+
+    for (std::thread& w : workers)
+        w.join();
+    return partials;
+}
+
+template <typename T>
+SumResult<T> SumSpan(std::span<const T> values, SumMode mode)
+{
+    constexpr std::size_t ParallelThreshold = 1 << 20;
+
+    switch (mode)
+    {
+    case SumMode::Kahan:
+        if constexpr (std::is_floating_point_v<T>)
+            return SumKahan(values);
+        return SumFast(values);
+
+    case SumMode::Pairwise:
+        if constexpr (std::is_floating_point_v<T>)
+            return SumTree<SumResult<T>>(SumBlocks(values, 1));
+        return SumFast(values);
+
+    case SumMode::Parallel:
+    {
+        // Small inputs are not worth the thread start-up; same blocks either way
+        unsigned threads = values.size() < ParallelThreshold ? 1 : std::max(1u, std::thread::hardware_concurrency());
+        return SumTree<SumResult<T>>(SumBlocks(values, threads));
+    }
+
+    default:
+        return SumFast(values);
+    }
+}
+
+// Overloads on the element type of the array
+long long sum(std::span<const int> values, SumMode mode = SumMode::Fast)
+{
+    return SumSpan(values, mode);
+}
+
+float sum(std::span<const float> values, SumMode mode = SumMode::Fast)
+{
+    return SumSpan(values, mode);
+}
+
+double sum(std::span<const double> values, SumMode mode = SumMode::Fast)
+{
+    return SumSpan(values, mode);
+}
+
+// ===========================================
+//        Prefix sums (scan) over arrays
+// ===========================================
+
+/*
+    A scan turns counts into running totals, e.g. counts {3, 1, 2} become
+    - inclusive : {3, 4, 6}   out[i] = in[0] + ... + in[i]
+    - exclusive : {0, 3, 4}   out[i] = in[0] + ... + in[i-1]
+    Both return the grand total (6), which is the final entry of an offset 
+    table. `in` and `out` must have the same size (std::invalid_argument 
+    otherwise) and may be the same array to scan in place. Integer totals 
+    wrap around on overflow, the same in every code path.
+
+    - int arrays are scanned 4 at a time inside an SSE2 register: shifting the 
+      register by one and two lanes and adding gives the running sum of the 4 
+      values, then the carry from the previous register is added.
+    - Large arrays use two passes over one chunk per core: first every chunk is 
+      summed, then each chunk is scanned starting from the total of all the 
+      chunks before it.
+*/
+
+// a + b; integers are added as unsigned and wrap like the SIMD lanes, since
+// signed overflow is undefined
+template <typename T>
+T ScanAdd(T a, T b)
+{
+    if constexpr (std::is_integral_v<T>)
+        return T(std::make_unsigned_t<T>(a) + std::make_unsigned_t<T>(b));
+    else
+        return a + b;
+}
+
+// Serial scan of one chunk starting at `carry`; returns the carry for the next
+template <typename T>
+T ScanChunk(std::span<const T> in, std::span<T> out, T carry, bool exclusive)
+{
+    std::size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64)
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 4)
+    {
+        __m128i carryVec = _mm_set1_epi32((int)carry);
+        for (; i + 4 <= in.size(); i += 4)
+        {
+            __m128i values = _mm_loadu_si128((const __m128i*)(in.data() + i));
+            __m128i x = _mm_add_epi32(values, _mm_slli_si128(values, 4));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi32(x, carryVec);
+
+            __m128i result = exclusive ? _mm_sub_epi32(x, values) : x;
+            _mm_storeu_si128((__m128i*)(out.data() + i), result);
+
+            // Broadcast the last lane as the next carry
+            carryVec = _mm_shuffle_epi32(x, 0xFF);
+        }
+        carry = (T)_mm_cvtsi128_si32(carryVec);
+    }
+#endif
+
+    for (; i < in.size(); i++)
+    {
+        T value = in[i];
+        T next = ScanAdd(carry, value);
+        out[i] = exclusive ? carry : next;
+        carry = next;
+    }
+    return carry;
+}
+
+template <typename T>
+T ScanSpan(std::span<const T> in, std::span<T> out, bool exclusive)
+{
+    constexpr std::size_t ParallelThreshold = 1 << 20;
+
+    if (in.size() != out.size())
+        throw std::invalid_argument("scan: input and output sizes do not match");
+    const std::size_t n = in.size();
+
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    if (n < ParallelThreshold || threads == 1)
+        return ScanChunk(in, out, T(0), exclusive);
+
+    const std::size_t chunk = (n + threads - 1) / threads;
+    std::vector<T> offsets(threads + 1, T(0));
+    std::vector<std::thread> workers;
+
+    // Pass 1: total of every chunk
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]
+        {
+            std::size_t begin = std::min(n, t * chunk);
+            T total = T(0);
+            for (T v : in.subspan(begin, std::min(chunk, n - begin)))
+                total = ScanAdd(total, v);
+            offsets[t + 1] = total;
+        });
+    }
+    for (std::thread& w : workers)
+        w.join();
+    workers.clear();
+
+    for (unsigned t = 0; t < threads; t++)
+        offsets[t + 1] = ScanAdd(offsets[t + 1], offsets[t]);
+
+    // Pass 2: scan every chunk from its starting offset
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]
+        {
+            std::size_t begin = std::min(n, t * chunk);
+            std::size_t count = std::min(chunk, n - begin);
+            ScanChunk(in.subspan(begin, count), out.subspan(begin, count), offsets[t], exclusive);
+        });
+    }
+    for (std::thread& w : workers)
+        w.join();
+
+    return offsets[threads];
+}
+
+int inclusive_scan(std::span<const int> in, std::span<int> out)
+{
+    return ScanSpan(in, out, false);
+}
+
+long long inclusive_scan(std::span<const long long> in, std::span<long long> out)
+{
+    return ScanSpan(in, out, false);
+}
+
+double inclusive_scan(std::span<const double> in, std::span<double> out)
+{
+    return ScanSpan(in, out, false);
+}
+
+int exclusive_scan(std::span<const int> in, std::span<int> out)
+{
+    return ScanSpan(in, out, true);
+}
+
+long long exclusive_scan(std::span<const long long> in, std::span<long long> out)
+{
+    return ScanSpan(in, out, true);
+}
+
+double exclusive_scan(std::span<const double> in, std::span<double> out)
+{
+    return ScanSpan(in, out, true);
+}
+
 // Overloaded functions with different param list and return type
 int invert(int a)
 {
@@ -99,10 +559,211 @@ double invert(double b)
     return -b;
 }
 
+// ===========================================
+//     Lazy element-wise array expressions
+// ===========================================
+
+/*
+    Writing `d = invert(a * b + c)` with ordinary array types creates a new 
+    temporary array for `a * b`, another for `+ c` and another for `invert`, and
+    walks memory once per step.
+
+    With expression templates the operators do no work at all; they only return
+    a small object describing the computation (its type is the "expression 
+    tree"). The work happens once, when the expression is assigned to an Array 
+    or reduced with sum(): a single loop computes each element through the 
+    whole tree, which the compiler inlines and vectorizes, with no temporaries.
+
+    The overloads of `invert`, `+`, `-` and `*` for expressions sit next to the 
+    scalar ones above and are chosen by the argument types, like any other 
+    overload.
+*/
+
+// Base of every expression node (CRTP), used to recognise expressions
+template <typename E>
+struct ArrayExpr
+{
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+template <typename E>
+concept IsArrayExpr = std::is_base_of_v<ArrayExpr<E>, E>;
+
+template <typename T>
+class Array;
+
+// Arrays are held by reference inside expressions, other nodes by value
+template <typename E>
+using ExprStorage = std::conditional_t<std::is_same_v<E, Array<typename E::value_type>>, const E&, E>;
+
+// A scalar used as an operand; every element has the same value
+template <typename T>
+struct ScalarExpr : ArrayExpr<ScalarExpr<T>>
+{
+    using value_type = T;
+    T value;
+
+    ScalarExpr(T v) : value(v) {}
+    T operator[](std::size_t) const { return value; }
+    std::size_t size() const { return 0; }
+};
+
+template <typename Op, typename E>
+struct UnaryExpr : ArrayExpr<UnaryExpr<Op, E>>
+{
+    using value_type = typename E::value_type;
+    ExprStorage<E> operand;
+
+    UnaryExpr(const E& e) : operand(e) {}
+    value_type operator[](std::size_t i) const { return Op{}(operand[i]); }
+    std::size_t size() const { return operand.size(); }
+};
+
+template <typename Op, typename L, typename R>
+struct BinaryExpr : ArrayExpr<BinaryExpr<Op, L, R>>
+{
+    using value_type = std::common_type_t<typename L::value_type, typename R::value_type>;
+    ExprStorage<L> left;
+    ExprStorage<R> right;
+
+    BinaryExpr(const L& l, const R& r) : left(l), right(r) {}
+    value_type operator[](std::size_t i) const { return Op{}(left[i], right[i]); }
+
+    // Scalars report size 0, so the array operand decides; two array 
+    // operands always have the same size (checked by MakeBinary)
+    std::size_t size() const { return std::max(left.size(), right.size()); }
+};
+
+// The only expression that owns memory
+template <typename T>
+class Array : public ArrayExpr<Array<T>>
+{
+private:
+    std::vector<T> data;
+
+public:
+    using value_type = T;
+
+    explicit Array(std::size_t n, T value = T()) : data(n, value) {}
+    Array(std::initializer_list<T> values) : data(values) {}
+
+    // Evaluating an expression: one fused loop over all elements
+    template <typename E>
+        requires IsArrayExpr<E>
+    Array(const ArrayExpr<E>& expr) : data(expr.self().size())
+    {
+        Assign(expr.self());
+    }
+
+    template <typename E>
+        requires IsArrayExpr<E>
+    Array& operator=(const ArrayExpr<E>& expr)
+    {
+        // The expression may read this array, so only resize when needed
+        if (data.size() != expr.self().size())
+        {
+            Array result(expr);
+            data.swap(result.data);
+            return *this;
+        }
+        Assign(expr.self());
+        return *this;
+    }
+
+    T operator[](std::size_t i) const { return data[i]; }
+    T& operator[](std::size_t i) { return data[i]; }
+    std::size_t size() const { return data.size(); }
+
+    const T* begin() const { return data.data(); }
+    const T* end() const { return data.data() + data.size(); }
+
+private:
+    template <typename E>
+    void Assign(const E& expr)
+    {
+        T* out = data.data();
+        const std::size_t n = data.size();
+        for (std::size_t i = 0; i < n; i++)
+            out[i] = expr[i];
+    }
+};
+
+// Operands are either expressions or plain numbers
+template <typename X>
+concept ExprOperand = IsArrayExpr<X> || std::is_arithmetic_v<X>;
+
+// Plain numbers are wrapped so every operand has operator[]
+template <typename X>
+using AsExprType = std::conditional_t<IsArrayExpr<X>, X, ScalarExpr<X>>;
+
+struct NegateOp { template <typename T> T operator()(T a) const { return -a; } };
+struct AddOp { template <typename A, typename B> auto operator()(A a, B b) const { return a + b; } };
+struct SubOp { template <typename A, typename B> auto operator()(A a, B b) const { return a - b; } };
+struct MulOp { template <typename A, typename B> auto operator()(A a, B b) const { return a * b; } };
+
+template <typename E>
+    requires IsArrayExpr<E>
+UnaryExpr<NegateOp, E> invert(const E& e)
+{
+    return UnaryExpr<NegateOp, E>(e);
+}
+
+template <typename Op, typename L, typename R>
+BinaryExpr<Op, AsExprType<L>, AsExprType<R>> MakeBinary(const L& l, const R& r)
+{
+    if constexpr (IsArrayExpr<L> && IsArrayExpr<R>)
+    {
+        if (l.size() != r.size())
+            throw std::invalid_argument("Array: operand sizes do not match");
+        return { l, r };
+    }
+    else if constexpr (IsArrayExpr<L>)
+        return { l, ScalarExpr<R>(r) };
+    else
+        return { ScalarExpr<L>(l), r };
+}
+
+template <ExprOperand L, ExprOperand R>
+    requires (IsArrayExpr<L> || IsArrayExpr<R>)
+auto operator+(const L& l, const R& r) { return MakeBinary<AddOp>(l, r); }
+
+template <ExprOperand L, ExprOperand R>
+    requires (IsArrayExpr<L> || IsArrayExpr<R>)
+auto operator-(const L& l, const R& r) { return MakeBinary<SubOp>(l, r); }
+
+template <ExprOperand L, ExprOperand R>
+    requires (IsArrayExpr<L> || IsArrayExpr<R>)
+auto operator*(const L& l, const R& r) { return MakeBinary<MulOp>(l, r); }
+
+// Fused reduction: evaluates and sums the expression in one pass. Integers are
+// summed in long long, as sum(std::span<const int>) does
+template <typename E>
+    requires IsArrayExpr<E>
+auto sum(const E& expr)
+{
+    using T = SumResult<typename E::value_type>;
+    constexpr std::size_t Lanes = 8;
+
+    T acc[Lanes] = {};
+    const std::size_t n = expr.size();
+    const std::size_t full = n - n % Lanes;
+    for (std::size_t i = 0; i < full; i += Lanes)
+        for (std::size_t j = 0; j < Lanes; j++)
+            acc[j] += expr[i + j];
+
+    T total = T();
+    for (std::size_t i = full; i < n; i++)
+        total += expr[i];
+    for (std::size_t j = 0; j < Lanes; j++)
+        total += acc[j];
+    return total;
+}
+
 void RunSample()
 {
     print(5);
     print(5.60);
+    FlushPrint();
 
     std::cout << sum(4, 5) << std::endl;
     std::cout << sum(4, 5, 6) << std::endl;
@@ -111,8 +772,199 @@ void RunSample()
     std::cout << invert(5.5) << std::endl;
 }
 
+void RunSample2()
+{
+    std::cout << sum(1, 2, 3, 4, 5) << std::endl;
+    std::cout << sum(1, 2.5f, 3.25) << std::endl;
+
+    std::vector<int> counts = { 4, 8, 15, 16, 23, 42 };
+    std::cout << sum(counts) << std::endl;
+
+    // A column with a few large values and many tiny ones
+    const std::size_t n = 1 << 24;
+    std::vector<double> column(n);
+    for (std::size_t i = 0; i < n; i++)
+        column[i] = (i % 1000 == 0) ? 1e8 : 0.1 + 1e-7 * (i % 7);
+
+    // Reference: long double Kahan sum
+    long double reference = 0, compensation = 0;
+    for (double v : column)
+    {
+        long double y = v - compensation;
+        long double t = reference + y;
+        compensation = (t - reference) - y;
+        reference = t;
+    }
+
+    std::cout.precision(17);
+    std::cout << "Reference : " << (double)reference << std::endl;
+
+    const std::pair<const char*, SumMode> modes[] = {
+        { "Fast    ", SumMode::Fast },
+        { "Kahan   ", SumMode::Kahan },
+        { "Pairwise", SumMode::Pairwise },
+        { "Parallel", SumMode::Parallel },
+    };
+
+    // Plain loop for comparison
+    auto start = std::chrono::steady_clock::now();
+    double naive = 0;
+    for (double v : column)
+        naive += v;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Naive loop: " << naive << "  error " << (double)(naive - reference) 
+              << "  " << n / elapsed.count() / 1e6 << " M/s" << std::endl;
+
+    for (const auto& [name, mode] : modes)
+    {
+        start = std::chrono::steady_clock::now();
+        double total = sum(column, mode);
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << "  : " << total << "  error " << (double)(total - reference) 
+                  << "  " << n / elapsed.count() / 1e6 << " M/s" << std::endl;
+    }
+    std::cout.precision(6);
+}
+
+void RunSample3()
+{
+    // CSR row pointers from per-row counts, scanned in place
+    std::vector<int> rowPtr = { 3, 1, 0, 2, 5, 0 };
+    rowPtr.push_back(0);
+    int total = exclusive_scan(rowPtr, rowPtr);
+    std::cout << "Row pointers:";
+    for (int v : rowPtr)
+        std::cout << " " << v;
+    std::cout << "  (nnz " << total << ")" << std::endl;
+
+    std::vector<double> weights = { 0.5, 0.25, 0.125 };
+    std::vector<double> running(weights.size());
+    inclusive_scan(weights, running);
+    std::cout << "Running: " << running[0] << " " << running[1] << " " << running[2] << std::endl;
+
+    // Benchmark against a plain serial loop
+    const std::size_t n = 1 << 24;
+    std::vector<int> counts(n), offsets(n);
+    for (std::size_t i = 0; i < n; i++)
+        counts[i] = (int)(i % 13);
+
+    auto start = std::chrono::steady_clock::now();
+    int carry = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        offsets[i] = carry;
+        carry += counts[i];
+    }
+    std::chrono::duration<double> serial = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    int scanned = exclusive_scan(counts, offsets);
+    std::chrono::duration<double> fast = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Serial loop   : " << n / serial.count() / 1e6 << " M/s (total " << carry << ")" << std::endl;
+    std::cout << "exclusive_scan: " << n / fast.count() / 1e6 << " M/s (total " << scanned << ")" << std::endl;
+}
+
+void RunSample4()
+{
+    Array<double> a = { 1, 2, 3, 4 };
+    Array<double> b = { 10, 20, 30, 40 };
+
+    // Nothing is computed until the assignment
+    Array<double> c = invert(a * b + 1.0) - a;
+    std::cout << "invert(a * b + 1) - a:";
+    for (double v : c)
+        std::cout << " " << v;
+    std::cout << std::endl;
+    std::cout << "sum(a * b) = " << sum(a * b) << std::endl;
+
+    // Pipelines of 3 to 6 stages, with every stage materialised vs fused
+    const std::size_t n = 1 << 22;
+    const int reps = 10;
+    Array<double> x(n, 1.5), y(n, 2.0), z(n, 0.5), out(n);
+
+    auto time = [&](auto&& body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++)
+            body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() * 1e3 / reps;
+    };
+
+    double unfused3 = time([&]
+    {
+        Array<double> t1 = x * y;
+        Array<double> t2 = t1 + z;
+        out = invert(t2);
+    });
+    double fused3 = time([&] { out = invert(x * y + z); });
+
+    double unfused6 = time([&]
+    {
+        Array<double> t1 = x * y;
+        Array<double> t2 = t1 + z;
+        Array<double> t3 = invert(t2);
+        Array<double> t4 = t3 * 3.0;
+        Array<double> t5 = t4 - x;
+        out = t5 + 1.0;
+    });
+    double fused6 = time([&] { out = invert(x * y + z) * 3.0 - x + 1.0; });
+
+    std::cout << "3 stages: temporaries " << unfused3 << " ms, fused " << fused3 << " ms" << std::endl;
+    std::cout << "6 stages: temporaries " << unfused6 << " ms, fused " << fused6 << " ms" << std::endl;
+}
+
+void RunSample5()
+{
+    std::vector<int> ints = { 1, 22, 333, -4444 };
+    std::vector<double> doubles = { 0.1, 1.0 / 3, 2.5e-300, 6.02214076e23 };
+    print(ints);
+    print(doubles);
+    FlushPrint();
+
+    // One million numbers to a file: iostream with endl vs the print buffer
+    const int count = 1000000;
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "print_benchmark.txt";
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream file(path);
+        for (int i = 0; i < count; i++)
+            file << "Double: " << i * 0.001 << std::endl;
+    }
+    std::chrono::duration<double> iostreamTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    {
+        std::FILE* file = std::fopen(path.string().c_str(), "wb");
+        PrintBuffer::Local().SetSink(file);
+        for (int i = 0; i < count; i++)
+            print(i * 0.001);
+        PrintBuffer::Local().SetSink(stdout);
+        std::fclose(file);
+    }
+    std::chrono::duration<double> bufferTime = std::chrono::steady_clock::now() - start;
+
+    std::filesystem::remove(path);
+    std::cout << "ofstream + endl : " << iostreamTime.count() * 1e3 << " ms" << std::endl;
+    std::cout << "print buffer    : " << bufferTime.count() * 1e3 << " ms" << std::endl;
+}
+
 int main()
 {
     std::cout << ">> Run Sample" << std::endl;
     RunSample();
+
+    std::cout << ">> Run Sample 2" << std::endl;
+    RunSample2();
+
+    std::cout << ">> Run Sample 3" << std::endl;
+    RunSample3();
+
+    std::cout << ">> Run Sample 4" << std::endl;
+    RunSample4();
+
+    std::cout << ">> Run Sample 5" << std::endl;
+    RunSample5();
 }
@@ -1,4 +1,26 @@
 #include <iostream>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
 
 /*
 
@@ -90,6 +112,189 @@ void RunSample1()
     wish - str;
 }
 
+// ===========================================
+//     Example : String builder (rope)
+// ===========================================
+
+/*
+    `a + b + c + ...` on std::string copies everything built so far at every 
+    step, so building a message from many fragments is quadratic and allocates 
+    over and over.
+
+    StringRope overloads + and += to only remember the fragments:
+    - string literals and lvalue strings are borrowed (no copy), so they must 
+      outlive the rope;
+    - rvalue strings (temporaries) are moved into the rope and kept alive by it.
+    The total length is tracked as fragments are added, so Flatten() allocates 
+    the result exactly once, and WriteTo() sends all fragments to a file 
+    descriptor with a single writev() call instead of joining them at all.
+*/
+
+class StringRope
+{
+private:
+
+    std::vector<std::string_view> fragments;
+    std::deque<std::string> owned;   // deque never moves its elements
+    std::size_t length = 0;
+
+public:
+
+    StringRope() {}
+
+    // Fragments that view `owned` strings must point at this rope's own 
+    // copies. Owned strings were appended in the same order as their 
+    // fragments, so one pass over both finds them.
+    StringRope(const StringRope& other) : length(other.length)
+    {
+        auto next = other.owned.begin();
+        fragments.reserve(other.fragments.size());
+        for (std::string_view fragment : other.fragments)
+        {
+            if (next != other.owned.end() && fragment.data() == next->data() && fragment.size() == next->size())
+            {
+                owned.push_back(*next++);
+                fragments.push_back(owned.back());
+            }
+            else
+                fragments.push_back(fragment);
+        }
+    }
+
+    // Moving a deque keeps its elements where they are, so views stay valid
+    StringRope(StringRope&& other) = default;
+
+    StringRope& operator = (StringRope other)
+    {
+        fragments.swap(other.fragments);
+        owned.swap(other.owned);
+        std::swap(length, other.length);
+        return *this;
+    }
+
+    StringRope& operator += (std::string_view str)
+    {
+        fragments.push_back(str);
+        length += str.size();
+        return *this;
+    }
+
+    StringRope& operator += (const char* str)
+    {
+        return *this += std::string_view(str);
+    }
+
+    StringRope& operator += (const std::string& str)
+    {
+        return *this += std::string_view(str);
+    }
+
+    StringRope& operator += (std::string&& str)
+    {
+        owned.push_back(std::move(str));
+        return *this += std::string_view(owned.back());
+    }
+
+    // `rope + x` moves the rope along the chain instead of copying it
+    template <typename S>
+    friend StringRope operator + (StringRope rope, S&& str)
+    {
+        rope += std::forward<S>(str);
+        return rope;
+    }
+
+    std::size_t size() const { return length; }
+
+    std::string Flatten() const
+    {
+        std::string result;
+        result.reserve(length);
+        for (std::string_view fragment : fragments)
+            result.append(fragment);
+        return result;
+    }
+
+    void WriteTo(std::ostream& out) const
+    {
+        for (std::string_view fragment : fragments)
+            out.write(fragment.data(), (std::streamsize)fragment.size());
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // Gathers the fragments straight from their own memory; returns false on 
+    // error. Calls interrupted by a signal (EINTR) are retried
+    bool WriteTo(int fd) const
+    {
+        std::vector<iovec> pending;
+        pending.reserve(fragments.size());
+        for (std::string_view fragment : fragments)
+            if (!fragment.empty())
+                pending.push_back({ const_cast<char*>(fragment.data()), fragment.size() });
+
+        std::size_t first = 0;
+        while (first < pending.size())
+        {
+            int batch = (int)std::min<std::size_t>(pending.size() - first, IOV_MAX);
+            ssize_t written = ::writev(fd, pending.data() + first, batch);
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+
+            // Skip what was written, possibly ending part way into a fragment
+            std::size_t done = (std::size_t)written;
+            while (first < pending.size() && done >= pending[first].iov_len)
+                done -= pending[first++].iov_len;
+            if (done > 0)
+            {
+                pending[first].iov_base = (char*)pending[first].iov_base + done;
+                pending[first].iov_len -= done;
+            }
+        }
+        return true;
+    }
+#endif
+};
+
+void RunSample5()
+{
+    std::string str = "Jayadev";
+    std::string wish = "Good Evening";
+
+    StringRope message = StringRope() + "Good Morning " + str + "\n" + wish + " " + str + "\n";
+    std::cout << message.Flatten();
+
+#if defined(__unix__) || defined(__APPLE__)
+    std::cout.flush();
+    message.WriteTo(STDOUT_FILENO);
+#endif
+
+    // Building a message from many fragments
+    const int count = 20000;
+    std::vector<std::string> words;
+    for (int i = 0; i < count; i++)
+        words.push_back("fragment" + std::to_string(i) + " ");
+
+    auto start = std::chrono::steady_clock::now();
+    std::string naive;
+    for (const std::string& word : words)
+        naive = naive + word;
+    std::chrono::duration<double> naiveTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    StringRope rope;
+    for (const std::string& word : words)
+        rope += word;
+    std::string flat = rope.Flatten();
+    std::chrono::duration<double> ropeTime = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Length " << naive.size() << " / " << flat.size() << std::endl;
+    std::cout << "str = str + word : " << naiveTime.count() * 1e3 << " ms" << std::endl;
+    std::cout << "StringRope       : " << ropeTime.count() * 1e3 << " ms" << std::endl;
+}
+
 // ===========================================
 //       Inside the class/structure
 //            Friend Functions
@@ -123,7 +328,7 @@ public:
     }
 
     // Unary operator overloading using friend function
-    friend DemoFriend operator ~ (DemoFriend& obj) 
+    friend DemoFriend operator ~ (const DemoFriend& obj) 
     {
         DemoFriend temp;
         temp.x = -obj.x;
@@ -131,7 +336,7 @@ public:
     }
 
     // Binary operator overloading using friend function
-    friend DemoFriend operator + (DemoFriend& obj1, DemoFriend& obj2) 
+    friend DemoFriend operator + (const DemoFriend& obj1, const DemoFriend& obj2) 
     {
         DemoFriend temp;
         temp.a = obj1.a + obj2.a;
@@ -231,6 +436,293 @@ void RunSample3()
     ob3.Show();
 
 }
+// ===========================================
+//      Example : Fixed-size vector Vec<N,T>
+// ===========================================
+
+/*
+    DemoFriend and DemoMember show the syntax with loose int members. Real 
+    geometry code wants the same operators on small vectors, and wants them to 
+    be fast:
+
+    - Vec<N,T> keeps its components in an aligned array padded to a register 
+      width (Vec<3,float> is stored as 4 floats, the last one always 0), so
+      every operator is one SSE/AVX instruction for N = 2, 3, 4 and 8.
+      Only float x 4/8 and double x 2/4 registers are specialized (the 8-float
+      and 4-double ones need AVX); any other combination, such as integer 
+      components or Vec<3,double> without AVX, uses plain per-component loops.
+    - Binary operators take `const Vec&`, and have rvalue overloads that reuse 
+      the storage of a temporary instead of creating another one.
+    - Compound assignment (+=, -=, *=) is the primitive; + - * are built on it.
+    - `~v` negates, like `~obj` on DemoFriend.
+
+    VecBatch<N,T> is the matching structure-of-arrays container: component 0 of
+    every vector is stored contiguously, then component 1, and so on, so batch
+    operations run over plain arrays.
+*/
+
+// Register-width operations on `W` values of type T; plain loops by default,
+// specialized below for float x 4/8 and double x 2/4 only
+template <typename T, std::size_t W>
+struct VecRegister
+{
+    static void Add(const T* a, const T* b, T* out) { for (std::size_t i = 0; i < W; i++) out[i] = a[i] + b[i]; }
+    static void Sub(const T* a, const T* b, T* out) { for (std::size_t i = 0; i < W; i++) out[i] = a[i] - b[i]; }
+    static void Mul(const T* a, const T* b, T* out) { for (std::size_t i = 0; i < W; i++) out[i] = a[i] * b[i]; }
+    static void Scale(const T* a, T s, T* out) { for (std::size_t i = 0; i < W; i++) out[i] = a[i] * s; }
+    static void Negate(const T* a, T* out) { for (std::size_t i = 0; i < W; i++) out[i] = -a[i]; }
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+template <>
+struct VecRegister<float, 4>
+{
+    static void Add(const float* a, const float* b, float* out) { _mm_store_ps(out, _mm_add_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+    static void Sub(const float* a, const float* b, float* out) { _mm_store_ps(out, _mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+    static void Mul(const float* a, const float* b, float* out) { _mm_store_ps(out, _mm_mul_ps(_mm_load_ps(a), _mm_load_ps(b))); }
+    static void Scale(const float* a, float s, float* out) { _mm_store_ps(out, _mm_mul_ps(_mm_load_ps(a), _mm_set1_ps(s))); }
+    static void Negate(const float* a, float* out) { _mm_store_ps(out, _mm_xor_ps(_mm_load_ps(a), _mm_set1_ps(-0.0f))); }
+};
+
+template <>
+struct VecRegister<double, 2>
+{
+    static void Add(const double* a, const double* b, double* out) { _mm_store_pd(out, _mm_add_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+    static void Sub(const double* a, const double* b, double* out) { _mm_store_pd(out, _mm_sub_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+    static void Mul(const double* a, const double* b, double* out) { _mm_store_pd(out, _mm_mul_pd(_mm_load_pd(a), _mm_load_pd(b))); }
+    static void Scale(const double* a, double s, double* out) { _mm_store_pd(out, _mm_mul_pd(_mm_load_pd(a), _mm_set1_pd(s))); }
+    static void Negate(const double* a, double* out) { _mm_store_pd(out, _mm_xor_pd(_mm_load_pd(a), _mm_set1_pd(-0.0))); }
+};
+
+#endif
+
+#if defined(__AVX__)
+
+template <>
+struct VecRegister<float, 8>
+{
+    static void Add(const float* a, const float* b, float* out) { _mm256_store_ps(out, _mm256_add_ps(_mm256_load_ps(a), _mm256_load_ps(b))); }
+    static void Sub(const float* a, const float* b, float* out) { _mm256_store_ps(out, _mm256_sub_ps(_mm256_load_ps(a), _mm256_load_ps(b))); }
+    static void Mul(const float* a, const float* b, float* out) { _mm256_store_ps(out, _mm256_mul_ps(_mm256_load_ps(a), _mm256_load_ps(b))); }
+    static void Scale(const float* a, float s, float* out) { _mm256_store_ps(out, _mm256_mul_ps(_mm256_load_ps(a), _mm256_set1_ps(s))); }
+    static void Negate(const float* a, float* out) { _mm256_store_ps(out, _mm256_xor_ps(_mm256_load_ps(a), _mm256_set1_ps(-0.0f))); }
+};
+
+template <>
+struct VecRegister<double, 4>
+{
+    static void Add(const double* a, const double* b, double* out) { _mm256_store_pd(out, _mm256_add_pd(_mm256_load_pd(a), _mm256_load_pd(b))); }
+    static void Sub(const double* a, const double* b, double* out) { _mm256_store_pd(out, _mm256_sub_pd(_mm256_load_pd(a), _mm256_load_pd(b))); }
+    static void Mul(const double* a, const double* b, double* out) { _mm256_store_pd(out, _mm256_mul_pd(_mm256_load_pd(a), _mm256_load_pd(b))); }
+    static void Scale(const double* a, double s, double* out) { _mm256_store_pd(out, _mm256_mul_pd(_mm256_load_pd(a), _mm256_set1_pd(s))); }
+    static void Negate(const double* a, double* out) { _mm256_store_pd(out, _mm256_xor_pd(_mm256_load_pd(a), _mm256_set1_pd(-0.0))); }
+};
+
+#endif
+
+// Vec<3,T> is padded to 4 lanes so it fits one register
+constexpr std::size_t VecWidth(std::size_t n)
+{
+    return n == 3 ? 4 : n;
+}
+
+// Register-sized arrays (up to 32 bytes, a power of two) are aligned to their
+// size for the aligned loads; any other size, e.g. Vec<5,float>, only needs T's
+template <typename T, std::size_t W>
+constexpr std::size_t VecAlign()
+{
+    constexpr std::size_t bytes = W * sizeof(T);
+    return std::has_single_bit(bytes) && bytes <= 32 ? bytes : alignof(T);
+}
+
+template <std::size_t N, typename T>
+class Vec
+{
+private:
+
+    static constexpr std::size_t W = VecWidth(N);
+    using Reg = VecRegister<T, W>;
+
+    alignas(VecAlign<T, W>()) T v[W] = {};
+
+public:
+
+    Vec() {}
+
+    // Vec<3,float> p(1, 2, 3);
+    // Components must convert to T, so a single Vec argument is never taken
+    // for a component when N == 1 (that is the copy constructor)
+    template <typename... Ts>
+        requires (sizeof...(Ts) == N && (std::convertible_to<Ts, T> && ...))
+    Vec(Ts... components) : v{ T(components)... }
+    {}
+
+    T operator[](std::size_t i) const { return v[i]; }
+    T& operator[](std::size_t i) { return v[i]; }
+
+    // Compound assignment
+    Vec& operator += (const Vec& o) { Reg::Add(v, o.v, v); return *this; }
+    Vec& operator -= (const Vec& o) { Reg::Sub(v, o.v, v); return *this; }
+    Vec& operator *= (const Vec& o) { Reg::Mul(v, o.v, v); return *this; }
+    Vec& operator *= (T s) { Reg::Scale(v, s, v); return *this; }
+
+    // Unary negation, as in DemoFriend
+    friend Vec operator ~ (const Vec& a) { Vec r; Reg::Negate(a.v, r.v); return r; }
+    friend Vec operator ~ (Vec&& a) { Reg::Negate(a.v, a.v); return std::move(a); }
+    friend Vec operator - (const Vec& a) { return ~a; }
+
+    // Binary operators on two lvalues
+    friend Vec operator + (const Vec& a, const Vec& b) { Vec r; Reg::Add(a.v, b.v, r.v); return r; }
+    friend Vec operator - (const Vec& a, const Vec& b) { Vec r; Reg::Sub(a.v, b.v, r.v); return r; }
+    friend Vec operator * (const Vec& a, const Vec& b) { Vec r; Reg::Mul(a.v, b.v, r.v); return r; }
+    friend Vec operator * (const Vec& a, T s) { Vec r; Reg::Scale(a.v, s, r.v); return r; }
+    friend Vec operator * (T s, const Vec& a) { return a * s; }
+
+    // Rvalue overloads: a temporary on the left is updated in place
+    friend Vec operator + (Vec&& a, const Vec& b) { a += b; return std::move(a); }
+    friend Vec operator - (Vec&& a, const Vec& b) { a -= b; return std::move(a); }
+    friend Vec operator * (Vec&& a, const Vec& b) { a *= b; return std::move(a); }
+    friend Vec operator * (Vec&& a, T s) { a *= s; return std::move(a); }
+
+    friend T Dot(const Vec& a, const Vec& b)
+    {
+        Vec p = a * b;
+        T total = T();
+        for (std::size_t i = 0; i < N; i++)
+            total += p.v[i];
+        return total;
+    }
+
+    void Show() const
+    {
+        std::cout << "(";
+        for (std::size_t i = 0; i < N; i++)
+            std::cout << (i ? ", " : "") << v[i];
+        std::cout << ")" << std::endl;
+    }
+};
+
+// Structure-of-arrays storage for many Vec<N,T>
+template <std::size_t N, typename T>
+class VecBatch
+{
+private:
+
+    std::vector<T> components[N];
+
+    void CheckSameSize(const VecBatch& o) const
+    {
+        if (size() != o.size())
+            throw std::invalid_argument("VecBatch: batch sizes do not match");
+    }
+
+public:
+
+    std::size_t size() const { return components[0].size(); }
+
+    void push_back(const Vec<N, T>& value)
+    {
+        for (std::size_t c = 0; c < N; c++)
+            components[c].push_back(value[c]);
+    }
+
+    Vec<N, T> operator[](std::size_t i) const
+    {
+        Vec<N, T> value;
+        for (std::size_t c = 0; c < N; c++)
+            value[c] = components[c][i];
+        return value;
+    }
+
+    // All values of one component, contiguous in memory
+    std::span<T> Component(std::size_t c) { return components[c]; }
+    std::span<const T> Component(std::size_t c) const { return components[c]; }
+
+    VecBatch& operator += (const VecBatch& o)
+    {
+        CheckSameSize(o);
+        for (std::size_t c = 0; c < N; c++)
+        {
+            T* dst = components[c].data();
+            const T* src = o.components[c].data();
+            const std::size_t n = size();
+            for (std::size_t i = 0; i < n; i++)
+                dst[i] += src[i];
+        }
+        return *this;
+    }
+
+    VecBatch& operator *= (T s)
+    {
+        for (std::vector<T>& component : components)
+            for (T& value : component)
+                value *= s;
+        return *this;
+    }
+
+    // this[i] += o[i] * s, the usual integration step
+    void AddScaled(const VecBatch& o, T s)
+    {
+        CheckSameSize(o);
+        for (std::size_t c = 0; c < N; c++)
+        {
+            T* dst = components[c].data();
+            const T* src = o.components[c].data();
+            const std::size_t n = size();
+            for (std::size_t i = 0; i < n; i++)
+                dst[i] += src[i] * s;
+        }
+    }
+};
+
+void RunSample4()
+{
+    Vec<3, float> a(1, 2, 3);
+    Vec<3, float> b(10, 20, 30);
+
+    (a + b).Show();
+    (~a).Show();
+    (a * b - a * 2.0f).Show();
+    std::cout << "Dot : " << Dot(a, b) << std::endl;
+
+    Vec<8, float> wide(1, 2, 3, 4, 5, 6, 7, 8);
+    (wide * wide).Show();
+
+    // No register for 5 ints: plain loops, aligned like int
+    Vec<5, int> odd(1, 2, 3, 4, 5);
+    (odd + odd * 10).Show();
+
+    // position += velocity * dt, array of Vec vs VecBatch
+    const std::size_t count = 1 << 20;
+    const int steps = 20;
+    const float dt = 0.01f;
+
+    std::vector<Vec<3, float>> positions(count), velocities(count, Vec<3, float>(1, 2, 3));
+    VecBatch<3, float> positionBatch, velocityBatch;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        positionBatch.push_back(positions[i]);
+        velocityBatch.push_back(velocities[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++)
+        for (std::size_t i = 0; i < count; i++)
+            positions[i] += velocities[i] * dt;
+    std::chrono::duration<double> aos = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++)
+        positionBatch.AddScaled(velocityBatch, dt);
+    std::chrono::duration<double> soa = std::chrono::steady_clock::now() - start;
+
+    positions[count - 1].Show();
+    positionBatch[count - 1].Show();
+    std::cout << "std::vector<Vec> : " << count * steps / aos.count() / 1e6 << " M updates/s" << std::endl;
+    std::cout << "VecBatch         : " << count * steps / soa.count() / 1e6 << " M updates/s" << std::endl;
+}
+
 // ==============
 //     Main
 // ==============
@@ -255,5 +747,11 @@ int main()
 
     std::cout << ">> Run Sample 3" << std::endl;
     RunSample3();
+
+    std::cout << ">> Run Sample 4" << std::endl;
+    RunSample4();
+
+    std::cout << ">> Run Sample 5" << std::endl;
+    RunSample5();
     return 0;
 }
\ No newline at end of file
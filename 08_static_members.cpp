@@ -1,4 +1,23 @@
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 /*
     ===========================================
@@ -62,33 +81,256 @@
 
 */
 
+// ===========================================
+//          Sharded Instance Counter
+// ===========================================
+
+/*
+    A plain `static int` counter is shared by every thread that creates objects,
+    so `count++` from two threads at once is a data race. Making it a single
+    `std::atomic<int>` fixes the race, but every increment then fights over the
+    same cache line, which bounces between cores and caps the constructor rate.
+
+    ShardedCounter splits the count into one slot per thread. Each slot sits on
+    its own cache line, so threads increment without disturbing each other, and
+    read() adds the slots up when the total is actually needed.
+*/
+
+constexpr std::size_t CacheLineSize = 64;
+
+template <std::size_t Shards = 64>
+class ShardedCounter
+{
+private:
+
+    struct alignas(CacheLineSize) Slot
+    {
+        std::atomic<long long> value{0};
+    };
+
+    Slot slots[Shards];
+
+    // Every thread is handed the next slot the first time it touches a counter
+    static std::size_t ShardIndex()
+    {
+        static std::atomic<std::size_t> nextShard{0};
+        thread_local std::size_t index =
+            nextShard.fetch_add(1, std::memory_order_relaxed) % Shards;
+        return index;
+    }
+
+public:
+
+    void Add(long long n)
+    {
+        slots[ShardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    ShardedCounter& operator++()
+    {
+        Add(1);
+        return *this;
+    }
+
+    // Sum of all slots; exact once the writing threads have finished
+    long long read() const
+    {
+        long long total = 0;
+        for (const Slot& slot : slots)
+            total += slot.value.load(std::memory_order_relaxed);
+        return total;
+    }
+};
+
+// ===========================================
+//       Pooled operator new / delete
+// ===========================================
+
+/*
+    A class can declare its own `operator new` and `operator delete`. They are
+    implicitly static members, so every `new MyClass` goes through them instead
+    of the general purpose heap.
+
+    FixedBlockPool hands out blocks of one fixed size:
+    - Each thread keeps a private free list (thread_local), so the common
+      allocate/free path is a couple of pointer moves with no locking.
+    - When a thread's list runs dry it takes a whole batch of blocks from the
+      shared global pool, carving a fresh chunk from the heap only if needed.
+    - When a thread's list grows past two batches it hands one batch back to
+      the global pool, so memory freed by one thread can be reused by another.
+
+    Deriving from PoolAllocated<T> gives T these class level operators.
+*/
+
+template <std::size_t BlockSize, std::size_t BlockAlign>
+class FixedBlockPool
+{
+private:
+
+    union Block
+    {
+        Block* next;
+        alignas(BlockAlign) unsigned char storage[BlockSize];
+    };
+
+    static constexpr std::size_t BatchSize = 256;
+
+    // A linked list of free blocks
+    struct FreeList
+    {
+        Block* head = nullptr;
+        std::size_t size = 0;
+
+        void Push(Block* block)
+        {
+            block->next = head;
+            head = block;
+            size++;
+        }
+
+        Block* Pop()
+        {
+            Block* block = head;
+            head = block->next;
+            size--;
+            return block;
+        }
+
+        // Detaches the first `n` blocks as a list of their own
+        FreeList Split(std::size_t n)
+        {
+            FreeList part;
+            for (std::size_t i = 0; i < n; i++)
+                part.Push(Pop());
+            return part;
+        }
+    };
+
+    // Batches shared by all threads, plus the chunks that back every block
+    struct GlobalPool
+    {
+        std::mutex lock;
+        std::vector<FreeList> batches;
+        std::vector<std::unique_ptr<Block[]>> chunks;
+
+        FreeList TakeBatch()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!batches.empty())
+            {
+                FreeList batch = batches.back();
+                batches.pop_back();
+                return batch;
+            }
+
+            chunks.emplace_back(new Block[BatchSize]);
+            FreeList batch;
+            for (std::size_t i = 0; i < BatchSize; i++)
+                batch.Push(&chunks.back()[i]);
+            return batch;
+        }
+
+        void ReturnBatch(FreeList batch)
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            batches.push_back(batch);
+        }
+    };
+
+    static GlobalPool& Global()
+    {
+        static GlobalPool global;
+        return global;
+    }
+
+    // Per-thread cache; whatever is left goes back to the global pool on exit
+    struct ThreadCache
+    {
+        FreeList blocks;
+
+        ~ThreadCache()
+        {
+            while (blocks.size > 0)
+                Global().ReturnBatch(blocks.Split(std::min(BatchSize, blocks.size)));
+        }
+    };
+
+    static ThreadCache& Cache()
+    {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+public:
+
+    static void* Allocate()
+    {
+        ThreadCache& cache = Cache();
+        if (cache.blocks.size == 0)
+            cache.blocks = Global().TakeBatch();
+        return cache.blocks.Pop();
+    }
+
+    static void Deallocate(void* p)
+    {
+        ThreadCache& cache = Cache();
+        cache.blocks.Push(static_cast<Block*>(p));
+        if (cache.blocks.size >= 2 * BatchSize)
+            Global().ReturnBatch(cache.blocks.Split(BatchSize));
+    }
+};
+
+template <typename T>
+class PoolAllocated
+{
+public:
+
+    static void* operator new(std::size_t size)
+    {
+        // A derived class of a different size falls back to the normal heap
+        if (size != sizeof(T))
+            return ::operator new(size);
+        return FixedBlockPool<sizeof(T), alignof(T)>::Allocate();
+    }
+
+    static void operator delete(void* p, std::size_t size)
+    {
+        if (p == nullptr)
+            return;
+        if (size != sizeof(T))
+            ::operator delete(p);
+        else
+            FixedBlockPool<sizeof(T), alignof(T)>::Deallocate(p);
+    }
+};
+
 // ===========================================
 //              Static Members
 // ===========================================
 
-class MyClass
+class MyClass : public PoolAllocated<MyClass>
 {
 private:
 
     // Static data member
-    static int count;
+    static ShardedCounter<> count;
 
 public:
 
     MyClass()
     {
-        count++;
+        ++count;
     }
 
     // Static member function
     static void DisplayCount()
     {
-        std::cout << "Count: " << count << std::endl;
+        std::cout << "Count: " << count.read() << std::endl;
     }
 };
 
 // Initialization of static member outside the class
-int MyClass::count = 0;
+ShardedCounter<> MyClass::count;
 
 void RunSample1()
 {
@@ -102,6 +344,259 @@ void RunSample1()
 //           Static Member Functions
 // ===========================================
 
+// ===========================================
+//       SIMD Lanes for MyUtility kernels
+// ===========================================
+
+/*
+    The span overloads of MyUtility are written once, against a small "lanes"
+    interface, and compiled for whatever the target supports:
+    - Avx2Lanes<T>   : 256-bit registers (8 x int32/float, 4 x int64/double),
+                       used when compiled with AVX2 (-mavx2 / -march=native).
+    - ScalarLanes<T> : one element at a time, used everywhere else.
+
+    The last partial register is handled with masked loads and stores, so there
+    is no scalar remainder loop and no branch on the element count.
+
+    Integer overflow is detected without branches: a + b overflowed exactly when
+    the sum has a different sign from both inputs, i.e. ((a ^ sum) & (b ^ sum))
+    is negative. Saturation then replaces the sum with MAX or MIN depending on
+    the sign of `a`. For float/double, "overflow" means the result is no longer
+    finite, and saturation clamps infinities to the largest finite value.
+*/
+
+template <typename T>
+struct ScalarLanes
+{
+    static constexpr std::size_t Width = 1;
+
+    using Reg = T;
+    using Flag = bool;
+    using Mask = bool;
+
+    static Reg Load(const T* p) { return *p; }
+    static void Store(T* p, Reg v) { *p = v; }
+    static Reg Broadcast(T v) { return v; }
+
+    // Width is 1, so the tail is always empty
+    static Mask TailMask(std::size_t) { return false; }
+    static Reg MaskLoad(const T*, Mask) { return T(); }
+    static void MaskStore(T*, Mask, Reg) {}
+
+    static Flag NoFlag() { return false; }
+    static Flag Or(Flag a, Flag b) { return a || b; }
+    static Flag AndMask(Flag f, Mask m) { return f && m; }
+    static bool Any(Flag f) { return f; }
+
+    static Reg Add(Reg a, Reg b)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return T(std::make_unsigned_t<T>(a) + std::make_unsigned_t<T>(b));
+        else
+            return a + b;
+    }
+
+    static Flag Overflow(Reg a, Reg b, Reg sum)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return ((a ^ sum) & (b ^ sum)) < 0;
+        else
+            return !std::isfinite(sum) && std::isfinite(a) && std::isfinite(b);
+    }
+
+    static Reg Saturate(Reg a, Reg b, Reg sum)
+    {
+        if constexpr (std::is_integral_v<T>)
+            return Overflow(a, b, sum) ? (a < 0 ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max()) : sum;
+        else
+            return std::clamp(sum, std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max());
+    }
+};
+
+#if defined(__AVX2__)
+
+template <typename T>
+struct Avx2Lanes;
+
+template <>
+struct Avx2Lanes<std::int32_t>
+{
+    using T = std::int32_t;
+    static constexpr std::size_t Width = 8;
+
+    using Reg = __m256i;
+    using Flag = __m256i;
+    using Mask = __m256i;
+
+    static Reg Load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void Store(T* p, Reg v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static Reg Broadcast(T v) { return _mm256_set1_epi32(v); }
+
+    // Sliding window over {-1 x 8, 0 x 8} gives the first `count` lanes set
+    static Mask TailMask(std::size_t count)
+    {
+        alignas(64) static const std::int32_t window[16] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+        return _mm256_loadu_si256((const __m256i*)(window + 8 - count));
+    }
+    static Reg MaskLoad(const T* p, Mask m) { return _mm256_maskload_epi32(p, m); }
+    static void MaskStore(T* p, Mask m, Reg v) { _mm256_maskstore_epi32(p, m, v); }
+
+    static Flag NoFlag() { return _mm256_setzero_si256(); }
+    static Flag Or(Flag a, Flag b) { return _mm256_or_si256(a, b); }
+    static Flag AndMask(Flag f, Mask m) { return _mm256_and_si256(f, m); }
+    static bool Any(Flag f) { return !_mm256_testz_si256(f, f); }
+
+    static Reg Add(Reg a, Reg b) { return _mm256_add_epi32(a, b); }
+
+    static Flag Overflow(Reg a, Reg b, Reg sum)
+    {
+        Reg both = _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum));
+        return _mm256_srai_epi32(both, 31);
+    }
+
+    static Reg Saturate(Reg a, Reg b, Reg sum)
+    {
+        Reg limit = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(INT32_MAX));
+        return _mm256_blendv_epi8(sum, limit, Overflow(a, b, sum));
+    }
+};
+
+template <>
+struct Avx2Lanes<std::int64_t>
+{
+    using T = std::int64_t;
+    static constexpr std::size_t Width = 4;
+
+    using Reg = __m256i;
+    using Flag = __m256i;
+    using Mask = __m256i;
+
+    static Reg Load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void Store(T* p, Reg v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static Reg Broadcast(T v) { return _mm256_set1_epi64x(v); }
+
+    static Mask TailMask(std::size_t count)
+    {
+        alignas(64) static const std::int64_t window[8] = { -1, -1, -1, -1 };
+        return _mm256_loadu_si256((const __m256i*)(window + 4 - count));
+    }
+    static Reg MaskLoad(const T* p, Mask m) { return _mm256_maskload_epi64((const long long*)p, m); }
+    static void MaskStore(T* p, Mask m, Reg v) { _mm256_maskstore_epi64((long long*)p, m, v); }
+
+    static Flag NoFlag() { return _mm256_setzero_si256(); }
+    static Flag Or(Flag a, Flag b) { return _mm256_or_si256(a, b); }
+    static Flag AndMask(Flag f, Mask m) { return _mm256_and_si256(f, m); }
+    static bool Any(Flag f) { return !_mm256_testz_si256(f, f); }
+
+    static Reg Add(Reg a, Reg b) { return _mm256_add_epi64(a, b); }
+
+    // AVX2 has no 64-bit arithmetic shift, so the sign is spread with a compare
+    static Flag Overflow(Reg a, Reg b, Reg sum)
+    {
+        Reg both = _mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(b, sum));
+        return _mm256_cmpgt_epi64(_mm256_setzero_si256(), both);
+    }
+
+    static Reg Saturate(Reg a, Reg b, Reg sum)
+    {
+        Reg sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), a);
+        Reg limit = _mm256_xor_si256(sign, _mm256_set1_epi64x(INT64_MAX));
+        return _mm256_blendv_epi8(sum, limit, Overflow(a, b, sum));
+    }
+};
+
+template <>
+struct Avx2Lanes<float>
+{
+    using T = float;
+    static constexpr std::size_t Width = 8;
+
+    using Reg = __m256;
+    using Flag = __m256;
+    using Mask = __m256i;
+
+    static Reg Load(const T* p) { return _mm256_loadu_ps(p); }
+    static void Store(T* p, Reg v) { _mm256_storeu_ps(p, v); }
+    static Reg Broadcast(T v) { return _mm256_set1_ps(v); }
+
+    static Mask TailMask(std::size_t count) { return Avx2Lanes<std::int32_t>::TailMask(count); }
+    static Reg MaskLoad(const T* p, Mask m) { return _mm256_maskload_ps(p, m); }
+    static void MaskStore(T* p, Mask m, Reg v) { _mm256_maskstore_ps(p, m, v); }
+
+    static Flag NoFlag() { return _mm256_setzero_ps(); }
+    static Flag Or(Flag a, Flag b) { return _mm256_or_ps(a, b); }
+    static Flag AndMask(Flag f, Mask m) { return _mm256_and_ps(f, _mm256_castsi256_ps(m)); }
+    static bool Any(Flag f) { return _mm256_movemask_ps(f) != 0; }
+
+    static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+
+    // x - x is NaN exactly when x is infinite or NaN
+    static Flag NotFinite(Reg x) { return _mm256_cmp_ps(_mm256_sub_ps(x, x), _mm256_setzero_ps(), _CMP_NEQ_UQ); }
+
+    static Flag Overflow(Reg a, Reg b, Reg sum)
+    {
+        return _mm256_andnot_ps(_mm256_or_ps(NotFinite(a), NotFinite(b)), NotFinite(sum));
+    }
+
+    // Operand order keeps NaN as NaN and only clamps infinities
+    static Reg Saturate(Reg, Reg, Reg sum)
+    {
+        Reg low = _mm256_set1_ps(std::numeric_limits<T>::lowest());
+        Reg high = _mm256_set1_ps(std::numeric_limits<T>::max());
+        return _mm256_min_ps(high, _mm256_max_ps(low, sum));
+    }
+};
+
+template <>
+struct Avx2Lanes<double>
+{
+    using T = double;
+    static constexpr std::size_t Width = 4;
+
+    using Reg = __m256d;
+    using Flag = __m256d;
+    using Mask = __m256i;
+
+    static Reg Load(const T* p) { return _mm256_loadu_pd(p); }
+    static void Store(T* p, Reg v) { _mm256_storeu_pd(p, v); }
+    static Reg Broadcast(T v) { return _mm256_set1_pd(v); }
+
+    static Mask TailMask(std::size_t count) { return Avx2Lanes<std::int64_t>::TailMask(count); }
+    static Reg MaskLoad(const T* p, Mask m) { return _mm256_maskload_pd(p, m); }
+    static void MaskStore(T* p, Mask m, Reg v) { _mm256_maskstore_pd(p, m, v); }
+
+    static Flag NoFlag() { return _mm256_setzero_pd(); }
+    static Flag Or(Flag a, Flag b) { return _mm256_or_pd(a, b); }
+    static Flag AndMask(Flag f, Mask m) { return _mm256_and_pd(f, _mm256_castsi256_pd(m)); }
+    static bool Any(Flag f) { return _mm256_movemask_pd(f) != 0; }
+
+    static Reg Add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+
+    static Flag NotFinite(Reg x) { return _mm256_cmp_pd(_mm256_sub_pd(x, x), _mm256_setzero_pd(), _CMP_NEQ_UQ); }
+
+    static Flag Overflow(Reg a, Reg b, Reg sum)
+    {
+        return _mm256_andnot_pd(_mm256_or_pd(NotFinite(a), NotFinite(b)), NotFinite(sum));
+    }
+
+    static Reg Saturate(Reg, Reg, Reg sum)
+    {
+        Reg low = _mm256_set1_pd(std::numeric_limits<T>::lowest());
+        Reg high = _mm256_set1_pd(std::numeric_limits<T>::max());
+        return _mm256_min_pd(high, _mm256_max_pd(low, sum));
+    }
+};
+
+template <typename T>
+using Lanes = Avx2Lanes<T>;
+
+#else
+
+template <typename T>
+using Lanes = ScalarLanes<T>;
+
+#endif
+
 class MyUtility
 {
 public:
@@ -109,6 +604,92 @@ public:
     {
         return a + b;
     }
+
+    // Element-wise out[i] = a[i] + b[i]
+    static void Add(std::span<const std::int32_t> a, std::span<const std::int32_t> b, std::span<std::int32_t> out) { Map<std::int32_t, Plain>(a, FromSpan<std::int32_t>{ b }, out); }
+    static void Add(std::span<const std::int64_t> a, std::span<const std::int64_t> b, std::span<std::int64_t> out) { Map<std::int64_t, Plain>(a, FromSpan<std::int64_t>{ b }, out); }
+    static void Add(std::span<const float> a, std::span<const float> b, std::span<float> out) { Map<float, Plain>(a, FromSpan<float>{ b }, out); }
+    static void Add(std::span<const double> a, std::span<const double> b, std::span<double> out) { Map<double, Plain>(a, FromSpan<double>{ b }, out); }
+
+    // Element-wise out[i] = a[i] + b (scalar broadcast)
+    static void Add(std::span<const std::int32_t> a, std::int32_t b, std::span<std::int32_t> out) { Map<std::int32_t, Plain>(a, FromScalar<std::int32_t>{ b }, out); }
+    static void Add(std::span<const std::int64_t> a, std::int64_t b, std::span<std::int64_t> out) { Map<std::int64_t, Plain>(a, FromScalar<std::int64_t>{ b }, out); }
+    static void Add(std::span<const float> a, float b, std::span<float> out) { Map<float, Plain>(a, FromScalar<float>{ b }, out); }
+    static void Add(std::span<const double> a, double b, std::span<double> out) { Map<double, Plain>(a, FromScalar<double>{ b }, out); }
+
+    // Element-wise add that clamps to the type's range instead of wrapping
+    static void AddSaturating(std::span<const std::int32_t> a, std::span<const std::int32_t> b, std::span<std::int32_t> out) { Map<std::int32_t, Saturating>(a, FromSpan<std::int32_t>{ b }, out); }
+    static void AddSaturating(std::span<const std::int64_t> a, std::span<const std::int64_t> b, std::span<std::int64_t> out) { Map<std::int64_t, Saturating>(a, FromSpan<std::int64_t>{ b }, out); }
+    static void AddSaturating(std::span<const float> a, std::span<const float> b, std::span<float> out) { Map<float, Saturating>(a, FromSpan<float>{ b }, out); }
+    static void AddSaturating(std::span<const double> a, std::span<const double> b, std::span<double> out) { Map<double, Saturating>(a, FromSpan<double>{ b }, out); }
+
+    // Element-wise add; returns false if any element overflowed
+    static bool AddChecked(std::span<const std::int32_t> a, std::span<const std::int32_t> b, std::span<std::int32_t> out) { return Map<std::int32_t, Checked>(a, FromSpan<std::int32_t>{ b }, out); }
+    static bool AddChecked(std::span<const std::int64_t> a, std::span<const std::int64_t> b, std::span<std::int64_t> out) { return Map<std::int64_t, Checked>(a, FromSpan<std::int64_t>{ b }, out); }
+    static bool AddChecked(std::span<const float> a, std::span<const float> b, std::span<float> out) { return Map<float, Checked>(a, FromSpan<float>{ b }, out); }
+    static bool AddChecked(std::span<const double> a, std::span<const double> b, std::span<double> out) { return Map<double, Checked>(a, FromSpan<double>{ b }, out); }
+
+private:
+
+    enum Mode { Plain, Saturating, Checked };
+
+    // Second operand read from an array
+    template <typename T>
+    struct FromSpan
+    {
+        std::span<const T> values;
+
+        typename Lanes<T>::Reg Load(std::size_t i) const { return Lanes<T>::Load(values.data() + i); }
+        typename Lanes<T>::Reg MaskLoad(std::size_t i, typename Lanes<T>::Mask m) const { return Lanes<T>::MaskLoad(values.data() + i, m); }
+        std::size_t Size(std::size_t) const { return values.size(); }
+    };
+
+    // Second operand broadcast to every lane
+    template <typename T>
+    struct FromScalar
+    {
+        T value;
+
+        typename Lanes<T>::Reg Load(std::size_t) const { return Lanes<T>::Broadcast(value); }
+        typename Lanes<T>::Reg MaskLoad(std::size_t, typename Lanes<T>::Mask) const { return Lanes<T>::Broadcast(value); }
+        std::size_t Size(std::size_t n) const { return n; }
+    };
+
+    // One kernel for every overload: full registers, then a single masked tail
+    template <typename T, Mode M, typename Operand>
+    static bool Map(std::span<const T> a, const Operand& b, std::span<T> out)
+    {
+        using L = Lanes<T>;
+        using Reg = typename L::Reg;
+        using Flag = typename L::Flag;
+
+        const std::size_t n = out.size();
+        if (a.size() != n || b.Size(n) != n)
+            throw std::invalid_argument("MyUtility: span sizes do not match");
+
+        auto step = [](Reg x, Reg y, Flag& overflow)
+        {
+            Reg sum = L::Add(x, y);
+            if constexpr (M == Saturating)
+                return L::Saturate(x, y, sum);
+            if constexpr (M == Checked)
+                overflow = L::Or(overflow, L::Overflow(x, y, sum));
+            return sum;
+        };
+
+        Flag overflow = L::NoFlag();
+        const std::size_t full = n - n % L::Width;
+        for (std::size_t i = 0; i < full; i += L::Width)
+            L::Store(out.data() + i, step(L::Load(a.data() + i), b.Load(i), overflow));
+
+        typename L::Mask tail = L::TailMask(n - full);
+        Flag tailOverflow = L::NoFlag();
+        Reg result = step(L::MaskLoad(a.data() + full, tail), b.MaskLoad(full, tail), tailOverflow);
+        L::MaskStore(out.data() + full, tail, result);
+        overflow = L::Or(overflow, L::AndMask(tailOverflow, tail));
+
+        return !L::Any(overflow);
+    }
 };
 
 void RunSample2()
@@ -118,6 +699,186 @@ void RunSample2()
     std::cout << "Sum: " << sum << std::endl;
 }
 
+// ===========================================
+//       Benchmark : Constructor Rate
+// ===========================================
+
+// Same class as MyClass, but counting with a single shared atomic
+class AtomicCounted
+{
+private:
+    static std::atomic<int> count;
+
+public:
+    AtomicCounted()
+    {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static long long Read() { return count.load(); }
+};
+
+std::atomic<int> AtomicCounted::count{0};
+
+// Constructs `perThread` objects on each of `threads` threads, returns Mctor/s
+template <typename T>
+double MeasureConstructorRate(int threads, int perThread)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([perThread]
+        {
+            for (int i = 0; i < perThread; i++)
+                T obj;
+        });
+    }
+    for (std::thread& w : workers)
+        w.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * (double)perThread / elapsed.count() / 1e6;
+}
+
+void RunSample3()
+{
+    const int perThread = 200000;
+
+    std::cout << "Threads  atomic<int> (M/s)  ShardedCounter (M/s)" << std::endl;
+    for (int threads = 1; threads <= 64; threads *= 2)
+    {
+        double atomicRate = MeasureConstructorRate<AtomicCounted>(threads, perThread);
+        double shardedRate = MeasureConstructorRate<MyClass>(threads, perThread);
+        std::cout << threads << "\t " << atomicRate << "\t\t     " << shardedRate << std::endl;
+    }
+
+    std::cout << "AtomicCounted objects: " << AtomicCounted::Read() << std::endl;
+    MyClass::DisplayCount();
+}
+
+// ===========================================
+//       Benchmark : Allocation Rate
+// ===========================================
+
+// A typical small object, once from the pool and once from the default heap
+struct PooledObject : public PoolAllocated<PooledObject>
+{
+    long long id;
+    double value = 0.0;
+    PooledObject* link = nullptr;
+
+    PooledObject(long long i) : id(i) {}
+};
+
+struct HeapObject
+{
+    long long id;
+    double value = 0.0;
+    HeapObject* link = nullptr;
+
+    HeapObject(long long i) : id(i) {}
+};
+
+// Each thread repeatedly allocates `live` objects then frees them, returns M/s
+template <typename T>
+double MeasureAllocationRate(int threads, int rounds, int live)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([rounds, live]
+        {
+            std::vector<T*> objects(live);
+            for (int r = 0; r < rounds; r++)
+            {
+                for (int i = 0; i < live; i++)
+                    objects[i] = new T(i);
+                for (int i = 0; i < live; i++)
+                    delete objects[i];
+            }
+        });
+    }
+    for (std::thread& w : workers)
+        w.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * (double)rounds * live / elapsed.count() / 1e6;
+}
+
+void RunSample4()
+{
+    // MyClass now allocates from its own pool
+    MyClass* p = new MyClass;
+    delete p;
+    MyClass::DisplayCount();
+
+    const int rounds = 2000;
+    const int live = 1000;
+
+    std::cout << "Threads  default new (M/s)  pooled new (M/s)" << std::endl;
+    for (int threads = 1; threads <= 8; threads *= 2)
+    {
+        double heapRate = MeasureAllocationRate<HeapObject>(threads, rounds, live);
+        double poolRate = MeasureAllocationRate<PooledObject>(threads, rounds, live);
+        std::cout << threads << "\t " << heapRate << "\t\t    " << poolRate << std::endl;
+    }
+}
+
+// ===========================================
+//       Span Utilities & Benchmark
+// ===========================================
+
+void RunSample5()
+{
+    std::vector<std::int32_t> a = { 1, 2, 3, INT32_MAX, -5, 6, 7, 8, 9, INT32_MIN, 11 };
+    std::vector<std::int32_t> b = { 10, 20, 30, 1, 50, 60, 70, 80, 90, -1, 110 };
+    std::vector<std::int32_t> out(a.size());
+
+    MyUtility::AddSaturating(a, b, out);
+    std::cout << "Saturating:";
+    for (std::int32_t v : out)
+        std::cout << " " << v;
+    std::cout << std::endl;
+
+    bool ok = MyUtility::AddChecked(a, b, out);
+    std::cout << "Checked add overflowed: " << (ok ? "no" : "yes") << std::endl;
+
+    std::vector<double> d = { 0.5, 1.5, 2.5 };
+    std::vector<double> dout(d.size());
+    MyUtility::Add(d, 10.0, dout);
+    std::cout << "Broadcast: " << dout[0] << " " << dout[1] << " " << dout[2] << std::endl;
+
+    // Scalar Add in a loop vs the span overload
+    const std::size_t n = 1 << 22;
+    const int reps = 20;
+    std::vector<std::int32_t> x(n, 3), y(n, 4), z(n);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+        for (std::size_t i = 0; i < n; i++)
+            z[i] = MyUtility::Add(x[i], y[i]);
+    std::chrono::duration<double> scalar = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+        MyUtility::Add(x, y, z);
+    std::chrono::duration<double> vectorized = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+        MyUtility::AddChecked(x, y, z);
+    std::chrono::duration<double> checked = std::chrono::steady_clock::now() - start;
+
+    double elements = (double)n * reps / 1e6;
+    std::cout << "Scalar loop : " << elements / scalar.count() << " M elements/s" << std::endl;
+    std::cout << "Span Add    : " << elements / vectorized.count() << " M elements/s" << std::endl;
+    std::cout << "Span Checked: " << elements / checked.count() << " M elements/s" << std::endl;
+}
+
 int main()
 {
     std::cout << ">> Run Sample 1" << std::endl;
@@ -126,5 +887,14 @@ int main()
     std::cout << ">> Run Sample 2" << std::endl;
     RunSample2();
 
+    std::cout << ">> Run Sample 3" << std::endl;
+    RunSample3();
+
+    std::cout << ">> Run Sample 4" << std::endl;
+    RunSample4();
+
+    std::cout << ">> Run Sample 5" << std::endl;
+    RunSample5();
+
     return 0;
 }
@@ -1,4 +1,33 @@
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 #define COUT(str) std::cout << str << std::endl;
 
 /*
@@ -76,16 +105,64 @@ void RunSample1()
     through the pointer.
 */
 
-class Base
+// Intrusive reference count, see the `intrusive_ptr` example further below
+enum class RefCountMode { Atomic, SingleThreaded };
+
+template <RefCountMode Mode = RefCountMode::Atomic>
+class RefCounted
+{
+private:
+
+    using Counter = std::conditional_t<Mode == RefCountMode::Atomic, std::atomic<int>, int>;
+    mutable Counter refs{0};
+
+public:
+
+    RefCounted() {}
+
+    // A copy is a new object, so it starts with no references
+    RefCounted(const RefCounted&) {}
+    RefCounted& operator=(const RefCounted&) { return *this; }
+
+    void AddRef() const
+    {
+        if constexpr (Mode == RefCountMode::Atomic)
+            refs.fetch_add(1, std::memory_order_relaxed);
+        else
+            ++refs;
+    }
+
+    // True when the last reference is gone and the object must be deleted
+    bool Release() const
+    {
+        if constexpr (Mode == RefCountMode::Atomic)
+            return refs.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        else
+            return --refs == 0;
+    }
+
+    int UseCount() const { return refs; }
+};
+
+class Base : public RefCounted<>
 {
 public:
     Base()
     {}
 
+    virtual ~Base()
+    {}
+
     virtual void Display()
     {
         COUT("Base class")
     }
+
+    // A cheap virtual call for the benchmarks below
+    virtual int Weight() const
+    {
+        return 1;
+    }
 };
 
 void RunSample2()
@@ -115,6 +192,11 @@ public:
     {
         COUT("Derived")
     }
+
+    int Weight() const override
+    {
+        return 2;
+    }
 };
 
 void RunSample3()
@@ -132,6 +214,1260 @@ void RunSample3()
     bptr->Display();
 }
 
+// =================================
+//      Asynchronous logging
+// =================================
+
+/*
+    COUT formats and writes on the calling thread, and std::endl flushes every 
+    time, so a log line in a hot loop costs microseconds. For hot paths use the 
+    LOG_* macros instead:
+
+    - The calling thread only copies a pointer to a static "log site" (level, 
+      format string, file, line) and the raw argument values into a fixed-size 
+      record in its own single-producer ring buffer. No locks, no formatting.
+    - A background thread drains every thread's ring, replaces each `{}` in the 
+      format with the next argument, and writes the text in large blocks. Once 
+      a thread has exited and its ring is drained, the ring is freed.
+    - Calls below LOG_MIN_LEVEL are discarded at compile time (`if constexpr`), 
+      so disabled LOG_DEBUG lines cost nothing at all.
+
+    If a ring is full the producer waits for the background thread instead of 
+    dropping records. Call Flush() before mixing LOG_* output with std::cout.
+*/
+
+enum class LogLevel : int { Trace, Debug, Info, Warn, Error };
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 2     // LogLevel::Info
+#endif
+
+struct LogSite
+{
+    LogLevel level;
+    const char* format;
+    const char* file;
+    int line;
+};
+
+enum class LogArgType : std::uint8_t { Int, UInt, Double, Pointer, Text };
+
+// One argument value; text is copied in and truncated to fit
+struct LogArg
+{
+    static constexpr std::size_t TextSize = 23;
+
+    LogArgType type;
+    union
+    {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+        char text[TextSize + 1];
+    };
+
+    template <typename T>
+    void Set(const T& value)
+    {
+        if constexpr (std::is_same_v<T, bool> || (std::is_integral_v<T> && std::is_signed_v<T>))
+        {
+            type = LogArgType::Int;
+            i = value;
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            type = LogArgType::UInt;
+            u = value;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            type = LogArgType::Double;
+            d = value;
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            std::string_view view = value;
+            std::size_t n = std::min(view.size(), TextSize);
+            type = LogArgType::Text;
+            std::memcpy(text, view.data(), n);
+            text[n] = '\0';
+        }
+        else
+        {
+            static_assert(std::is_pointer_v<T>, "unsupported log argument type");
+            type = LogArgType::Pointer;
+            p = value;
+        }
+    }
+};
+
+struct LogRecord
+{
+    static constexpr std::size_t MaxArgs = 4;
+
+    const LogSite* site;
+    std::int64_t timestamp;
+    std::size_t count;
+    LogArg args[MaxArgs];
+};
+
+// Single producer / single consumer ring of log records
+class LogRing
+{
+private:
+
+    static constexpr std::size_t Capacity = 1 << 12;
+
+    LogRecord records[Capacity];
+
+    // Written by the producer and the consumer respectively, on separate lines
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+    std::atomic<bool> ownerExited{false};
+
+public:
+
+    // Producer side: the slot to fill, or nullptr when the ring is full
+    LogRecord* Claim()
+    {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity)
+            return nullptr;
+        return &records[h % Capacity];
+    }
+
+    void Publish()
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side: calls `f` on every available record, returns how many
+    template <typename F>
+    std::size_t Drain(F&& f)
+    {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        std::size_t h = head.load(std::memory_order_acquire);
+        for (std::size_t i = t; i < h; i++)
+            f(records[i % Capacity]);
+        tail.store(h, std::memory_order_release);
+        return h - t;
+    }
+
+    bool Empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    // Set by the producer thread on exit, after its last Publish()
+    void MarkOwnerExited() { ownerExited.store(true, std::memory_order_release); }
+
+    // True once the producer has exited and every record has been drained
+    bool Retired() const
+    {
+        return ownerExited.load(std::memory_order_acquire) && Empty();
+    }
+};
+
+class AsyncLogger
+{
+private:
+
+    std::mutex ringsLock;
+    std::vector<std::shared_ptr<LogRing>> rings;
+
+    std::mutex sinkLock;
+    std::FILE* sink = stdout;
+
+    std::atomic<bool> running{true};
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread worker;
+
+    AsyncLogger()
+    {
+        worker = std::thread([this] { Run(); });
+    }
+
+    ~AsyncLogger()
+    {
+        running = false;
+        worker.join();
+        DrainAll();
+    }
+
+    // Marks the thread's ring when the thread exits
+    struct LocalRingOwner
+    {
+        std::shared_ptr<LogRing> ring;
+
+        ~LocalRingOwner() { ring->MarkOwnerExited(); }
+    };
+
+    LogRing& LocalRing()
+    {
+        // The registry shares ownership, so records outlive their thread
+        thread_local LocalRingOwner owner{ [this]
+        {
+            auto created = std::make_shared<LogRing>();
+            std::lock_guard<std::mutex> guard(ringsLock);
+            rings.push_back(created);
+            return created;
+        }() };
+        return *owner.ring;
+    }
+
+    static void Format(const LogRecord& record, std::string& out)
+    {
+        static const char* names[] = { "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR" };
+        char number[32];
+
+        out += '[';
+        out += names[(int)record.site->level];
+        out += ' ';
+        out.append(number, std::to_chars(number, number + sizeof(number), record.timestamp / 1000).ptr);
+        out += "us] ";
+
+        std::size_t next = 0;
+        for (const char* f = record.site->format; *f; f++)
+        {
+            if (f[0] != '{' || f[1] != '}' || next >= record.count)
+            {
+                out += *f;
+                continue;
+            }
+
+            const LogArg& arg = record.args[next++];
+            char* end = number;
+            switch (arg.type)
+            {
+            case LogArgType::Int:     end = std::to_chars(number, number + sizeof(number), arg.i).ptr; break;
+            case LogArgType::UInt:    end = std::to_chars(number, number + sizeof(number), arg.u).ptr; break;
+            case LogArgType::Double:  end = std::to_chars(number, number + sizeof(number), arg.d).ptr; break;
+            case LogArgType::Pointer: end = std::to_chars(number, number + sizeof(number), (std::uintptr_t)arg.p, 16).ptr; break;
+            case LogArgType::Text:    out += arg.text; break;
+            }
+            out.append(number, end);
+            f++;
+        }
+        out += '\n';
+    }
+
+    // Formats everything currently queued; returns the number of records
+    std::size_t DrainAll()
+    {
+        std::vector<std::shared_ptr<LogRing>> snapshot;
+        {
+            std::lock_guard<std::mutex> guard(ringsLock);
+            snapshot = rings;
+        }
+
+        std::string text;
+        std::size_t drained = 0;
+        std::lock_guard<std::mutex> guard(sinkLock);
+        for (const std::shared_ptr<LogRing>& ring : snapshot)
+        {
+            drained += ring->Drain([&](const LogRecord& record)
+            {
+                Format(record, text);
+                if (text.size() > (1 << 16))
+                {
+                    std::fwrite(text.data(), 1, text.size(), sink);
+                    text.clear();
+                }
+            });
+        }
+        std::fwrite(text.data(), 1, text.size(), sink);
+
+        // Rings of exited threads are not needed once drained
+        {
+            std::lock_guard<std::mutex> guard(ringsLock);
+            std::erase_if(rings, [](const std::shared_ptr<LogRing>& ring) { return ring->Retired(); });
+        }
+        return drained;
+    }
+
+    void Run()
+    {
+        while (running)
+        {
+            if (DrainAll() == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+
+public:
+
+    static AsyncLogger& Instance()
+    {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    template <typename... Args>
+    void Write(const LogSite& site, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= LogRecord::MaxArgs, "too many log arguments");
+
+        LogRing& ring = LocalRing();
+        LogRecord* record;
+        while ((record = ring.Claim()) == nullptr)
+            std::this_thread::yield();
+
+        record->site = &site;
+        record->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        record->count = sizeof...(Args);
+
+        std::size_t i = 0;
+        (record->args[i++].Set(args), ...);
+        ring.Publish();
+    }
+
+    // Waits until every queued record has been written out
+    void Flush()
+    {
+        for (;;)
+        {
+            bool empty = true;
+            {
+                std::lock_guard<std::mutex> guard(ringsLock);
+                for (const std::shared_ptr<LogRing>& ring : rings)
+                    empty = empty && ring->Empty();
+            }
+            if (empty)
+                break;
+            std::this_thread::yield();
+        }
+
+        // The worker holds sinkLock while writing what it drained
+        std::lock_guard<std::mutex> guard(sinkLock);
+        std::fflush(sink);
+    }
+
+    void SetSink(std::FILE* file)
+    {
+        Flush();
+        std::lock_guard<std::mutex> guard(sinkLock);
+        sink = file;
+    }
+};
+
+#define LOG(level, format, ...)                                                   \
+    do                                                                            \
+    {                                                                             \
+        if constexpr ((int)(level) >= LOG_MIN_LEVEL)                              \
+        {                                                                         \
+            static constexpr LogSite logSite{ level, format, __FILE__, __LINE__ }; \
+            AsyncLogger::Instance().Write(logSite __VA_OPT__(,) __VA_ARGS__);     \
+        }                                                                         \
+    } while (0)
+
+#define LOG_TRACE(...) LOG(LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...) LOG(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)  LOG(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...)  LOG(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LOG(LogLevel::Error, __VA_ARGS__)
+
+void RunSample4()
+{
+    MyClass obj(5);
+    Derived d;
+    Base* bptr = &d;
+
+    LOG_INFO("MyClass x = {}", obj.x);
+    LOG_WARN("Base pointer {} refers to a {}", (const void*)bptr, "Derived");
+    LOG_DEBUG("Compiled out below LOG_MIN_LEVEL: {}", obj.x);
+    AsyncLogger::Instance().Flush();
+
+    // Hot loop: one million log lines, written to a file either way
+    const int count = 1000000;
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "log_benchmark.txt";
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream file(path);
+        for (int i = 0; i < count; i++)
+            file << "iteration " << i << " value " << i * 0.5 << std::endl;
+    }
+    std::chrono::duration<double> synchronous = std::chrono::steady_clock::now() - start;
+
+    std::FILE* file = std::fopen(path.string().c_str(), "wb");
+    AsyncLogger::Instance().SetSink(file);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+        LOG_INFO("iteration {} value {}", i, i * 0.5);
+    std::chrono::duration<double> producer = std::chrono::steady_clock::now() - start;
+    AsyncLogger::Instance().Flush();
+    std::chrono::duration<double> total = std::chrono::steady_clock::now() - start;
+
+    // Bursts that fit in the ring show the cost seen by the calling thread alone
+    const int burst = 4000;
+    std::chrono::duration<double> bursts{0};
+    for (int b = 0; b < count / burst; b++)
+    {
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < burst; i++)
+            LOG_INFO("iteration {} value {}", i, i * 0.5);
+        bursts += std::chrono::steady_clock::now() - start;
+        AsyncLogger::Instance().Flush();
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+        LOG_DEBUG("iteration {} value {}", i, i * 0.5);
+    std::chrono::duration<double> disabled = std::chrono::steady_clock::now() - start;
+
+    AsyncLogger::Instance().SetSink(stdout);
+    std::fclose(file);
+    std::filesystem::remove(path);
+
+    std::cout << "ofstream + endl : " << synchronous.count() * 1e9 / count << " ns/line" << std::endl;
+    std::cout << "LOG_INFO caller : " << producer.count() * 1e9 / count << " ns/line ("
+              << total.count() * 1e9 / count << " ns/line until written)" << std::endl;
+    std::cout << "LOG_INFO bursts : " << bursts.count() * 1e9 / (count / burst * burst) << " ns/line" << std::endl;
+    std::cout << "LOG_DEBUG (off) : " << disabled.count() * 1e9 / count << " ns/line" << std::endl;
+}
+
+// =================================
+//    Sorting objects by a key
+// =================================
+
+/*
+    MyClass::compare looks at two objects at a time. Sorting many objects with 
+    such a comparison (std::sort) costs O(n log n) comparisons, most of them 
+    unpredictable branches.
+
+    RadixSort never compares. It looks at the key one byte (digit) at a time, 
+    from the least significant byte up (LSD), and for each byte distributes the 
+    objects into 256 buckets in order. Each pass is stable, so after the last 
+    byte the objects are fully sorted, and equal keys keep their original order.
+
+    - Every pass is parallel: each thread counts the digits of its own slice, 
+      the counts give every (digit, thread) pair its own output range, and the 
+      threads then scatter their slices without any locking.
+    - A pass where every key has the same digit (e.g. the high bytes of small 
+      numbers) is skipped.
+    - The key extractor returns any integer type; signed keys are sorted 
+      correctly by flipping the sign bit.
+
+    RadixSortedOrder sorts (key, index) pairs instead of the objects, for when 
+    the objects are large or must not move. DedupSorted removes repeated keys 
+    from sorted objects in one linear pass, keeping the first of each.
+*/
+
+// Runs fn(t) for t in [0, threads), the first one on the calling thread
+template <typename F>
+void ParallelFor(unsigned threads, F&& fn)
+{
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; t++)
+        workers.emplace_back(fn, t);
+    fn(0u);
+    for (std::thread& w : workers)
+        w.join();
+}
+
+template <typename K>
+auto RadixKey(K key)
+{
+    using U = std::make_unsigned_t<K>;
+    if constexpr (std::is_signed_v<K>)
+        return U(key) ^ (U(1) << (sizeof(K) * 8 - 1));
+    else
+        return U(key);
+}
+
+template <typename T, typename KeyFn>
+void RadixSort(std::vector<T>& items, KeyFn key)
+{
+    using K = std::invoke_result_t<KeyFn, const T&>;
+    static_assert(std::is_integral_v<K>, "RadixSort needs an integer key");
+
+    const std::size_t n = items.size();
+    if (n < 2)
+        return;
+
+    const unsigned threads = n < (1 << 16) ? 1 : std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t chunk = (n + threads - 1) / threads;
+    auto sliceBegin = [&](unsigned t) { return std::min(n, t * chunk); };
+    auto sliceEnd = [&](unsigned t) { return std::min(n, (t + 1) * chunk); };
+
+    std::vector<T> buffer(items);
+    T* src = items.data();
+    T* dst = buffer.data();
+    std::vector<std::array<std::size_t, 256>> counts(threads);
+
+    for (unsigned shift = 0; shift < sizeof(K) * 8; shift += 8)
+    {
+        auto digit = [&](const T& item) { return (RadixKey(key(item)) >> shift) & 0xFF; };
+
+        ParallelFor(threads, [&](unsigned t)
+        {
+            counts[t].fill(0);
+            for (std::size_t i = sliceBegin(t); i < sliceEnd(t); i++)
+                counts[t][digit(src[i])]++;
+        });
+
+        // Turn the counts into starting offsets, digit-major then thread
+        std::size_t offset = 0;
+        bool trivial = false;
+        for (std::size_t d = 0; d < 256; d++)
+        {
+            std::size_t start = offset;
+            for (unsigned t = 0; t < threads; t++)
+            {
+                std::size_t c = counts[t][d];
+                counts[t][d] = offset;
+                offset += c;
+            }
+            trivial = trivial || (offset - start == n);
+        }
+        if (trivial)
+            continue;
+
+        ParallelFor(threads, [&](unsigned t)
+        {
+            std::array<std::size_t, 256>& next = counts[t];
+            for (std::size_t i = sliceBegin(t); i < sliceEnd(t); i++)
+                dst[next[digit(src[i])]++] = src[i];
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != items.data())
+        std::copy(src, src + n, items.data());
+}
+
+// Stable sorted order of `items` by key, as indices; the items do not move
+template <typename T, typename KeyFn>
+std::vector<std::uint32_t> RadixSortedOrder(std::span<const T> items, KeyFn key)
+{
+    using K = std::invoke_result_t<KeyFn, const T&>;
+    struct KeyIndex
+    {
+        K key;
+        std::uint32_t index;
+    };
+
+    std::vector<KeyIndex> pairs;
+    pairs.reserve(items.size());
+    for (std::size_t i = 0; i < items.size(); i++)
+        pairs.push_back({ key(items[i]), (std::uint32_t)i });
+
+    RadixSort(pairs, [](const KeyIndex& p) { return p.key; });
+
+    std::vector<std::uint32_t> order;
+    order.reserve(pairs.size());
+    for (const KeyIndex& p : pairs)
+        order.push_back(p.index);
+    return order;
+}
+
+// Keeps the first object of every run of equal keys; returns the new size
+template <typename T, typename KeyFn>
+std::size_t DedupSorted(std::vector<T>& items, KeyFn key)
+{
+    auto last = std::unique(items.begin(), items.end(),
+        [&](const T& a, const T& b) { return key(a) == key(b); });
+    items.erase(last, items.end());
+    return items.size();
+}
+
+void RunSample5()
+{
+    std::vector<MyClass> small = { MyClass(30), MyClass(-5), MyClass(12), MyClass(30), MyClass(-5), MyClass(7) };
+    auto byX = [](const MyClass& obj) { return obj.x; };
+
+    std::vector<std::uint32_t> order = RadixSortedOrder(std::span<const MyClass>(small), byX);
+    std::cout << "Sorted order:";
+    for (std::uint32_t i : order)
+        std::cout << " " << i;
+    std::cout << std::endl;
+
+    RadixSort(small, byX);
+    DedupSorted(small, byX);
+    for (MyClass& obj : small)
+        obj.print();
+
+    // Benchmark on random keys
+    const std::size_t n = 1 << 22;
+    std::mt19937 rng(7);
+    std::vector<MyClass> input;
+    input.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+        input.emplace_back((int)(rng() % (n / 2)));
+
+    auto byXLess = [](const MyClass& a, const MyClass& b) { return a.x < b.x; };
+    auto time = [&](auto&& sortFn)
+    {
+        std::vector<MyClass> copy = input;
+        auto start = std::chrono::steady_clock::now();
+        sortFn(copy);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        bool sorted = std::is_sorted(copy.begin(), copy.end(), byXLess);
+        std::cout << elapsed.count() * 1e3 << " ms" << (sorted ? "" : "  NOT SORTED") << std::endl;
+        return copy;
+    };
+
+    std::cout << "std::sort        : ";
+    time([&](std::vector<MyClass>& v) { std::sort(v.begin(), v.end(), byXLess); });
+    std::cout << "std::stable_sort : ";
+    time([&](std::vector<MyClass>& v) { std::stable_sort(v.begin(), v.end(), byXLess); });
+    std::cout << "RadixSort        : ";
+    std::vector<MyClass> sorted = time([&](std::vector<MyClass>& v) { RadixSort(v, byX); });
+
+    auto start = std::chrono::steady_clock::now();
+    std::size_t unique = DedupSorted(sorted, byX);
+    std::chrono::duration<double> dedup = std::chrono::steady_clock::now() - start;
+    std::cout << "DedupSorted      : " << dedup.count() * 1e3 << " ms, " << unique << " unique keys" << std::endl;
+}
+
+// =================================
+//    Flat hash map keyed by integer
+// =================================
+
+/*
+    std::unordered_map allocates a separate node for every element and chains 
+    them with pointers, so every lookup chases pointers around the heap.
+
+    FlatIntMap stores the elements themselves in one array (open addressing), 
+    in the style of a "Swiss table":
+    - Next to the elements is an array of control bytes, one per slot: empty,
+      deleted, or the low 7 bits of the key's hash (h2) if the slot is full.
+    - Slots are probed 16 at a time. One SSE2 compare checks the 16 control 
+      bytes of a group against h2 at once, so only slots whose hash matches are 
+      ever compared by key; an empty byte in the group ends the search.
+    - erase() leaves a "deleted" marker (tombstone) so later probes continue 
+      past it; rehashing removes tombstones.
+    - reserve() sizes the table once for a known number of elements, and the 
+      table grows when 7/8 full.
+*/
+
+template <typename K, typename V>
+class FlatIntMap
+{
+    static_assert(std::is_integral_v<K>, "FlatIntMap needs an integer key");
+
+public:
+
+    using value_type = std::pair<K, V>;
+
+private:
+
+    static constexpr std::size_t GroupSize = 16;
+    static constexpr std::int8_t Empty = -128;      // 0b10000000
+    static constexpr std::int8_t Deleted = -2;      // 0b11111110
+
+    std::int8_t* ctrl = nullptr;
+    value_type* slots = nullptr;
+    std::size_t capacity = 0;       // power of two, multiple of GroupSize
+    std::size_t count = 0;
+    std::size_t tombstones = 0;
+
+    static std::uint64_t Hash(K key)
+    {
+        // MurmurHash3 finalizer: every key bit affects every hash bit
+        std::uint64_t h = (std::uint64_t)key;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Bit i set when ctrl[i] of the group equals `byte`
+    static std::uint32_t Match(const std::int8_t* group, std::int8_t byte)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128i bytes = _mm_loadu_si128((const __m128i*)group);
+        return (std::uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(byte)));
+#else
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < GroupSize; i++)
+            bits |= std::uint32_t(group[i] == byte) << i;
+        return bits;
+#endif
+    }
+
+    // Bit i set when slot i of the group is empty or deleted (sign bit set)
+    static std::uint32_t MatchFree(const std::int8_t* group)
+    {
+#if defined(__SSE2__) || defined(_M_X64)
+        return (std::uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < GroupSize; i++)
+            bits |= std::uint32_t(group[i] < 0) << i;
+        return bits;
+#endif
+    }
+
+    // Results of a probe step: keep probing, or stop with nothing found
+    static constexpr std::size_t Continue = SIZE_MAX;
+    static constexpr std::size_t NotFound = SIZE_MAX - 1;
+
+    // Calls visit(first slot of group) in probe order until it returns a result
+    template <typename F>
+    std::size_t Probe(std::uint64_t hash, F&& visit) const
+    {
+        const std::size_t groups = capacity / GroupSize;
+        std::size_t group = (hash >> 7) & (groups - 1);
+        for (std::size_t step = 1; ; step++)
+        {
+            std::size_t result = visit(group * GroupSize);
+            if (result != Continue)
+                return result;
+            group = (group + step) & (groups - 1);     // triangular probing visits every group
+        }
+    }
+
+    std::size_t FindIndex(K key) const
+    {
+        if (capacity == 0)
+            return NotFound;
+
+        const std::uint64_t hash = Hash(key);
+        const std::int8_t h2 = (std::int8_t)(hash & 0x7F);
+        return Probe(hash, [&](std::size_t base) -> std::size_t
+        {
+            for (std::uint32_t bits = Match(ctrl + base, h2); bits != 0; bits &= bits - 1)
+            {
+                std::size_t i = base + std::countr_zero(bits);
+                if (slots[i].first == key)
+                    return i;
+            }
+            // An empty slot means the key was never inserted further along
+            return Match(ctrl + base, Empty) ? NotFound : Continue;
+        });
+    }
+
+    void Rehash(std::size_t newCapacity)
+    {
+        std::int8_t* oldCtrl = ctrl;
+        value_type* oldSlots = slots;
+        std::size_t oldCapacity = capacity;
+
+        capacity = newCapacity;
+        ctrl = new std::int8_t[capacity];
+        std::fill(ctrl, ctrl + capacity, Empty);
+        slots = static_cast<value_type*>(::operator new(capacity * sizeof(value_type), std::align_val_t(alignof(value_type))));
+        count = 0;
+        tombstones = 0;
+
+        for (std::size_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldCtrl[i] >= 0)
+            {
+                InsertNew(std::move(oldSlots[i]));
+                oldSlots[i].~value_type();
+            }
+        }
+        delete[] oldCtrl;
+        ::operator delete(oldSlots, std::align_val_t(alignof(value_type)));
+    }
+
+    // Inserts a key that is known not to be present
+    value_type* InsertNew(value_type&& element)
+    {
+        const std::uint64_t hash = Hash(element.first);
+        std::size_t index = Probe(hash, [&](std::size_t base) -> std::size_t
+        {
+            std::uint32_t free = MatchFree(ctrl + base);
+            return free ? base + std::countr_zero(free) : Continue;
+        });
+
+        if (ctrl[index] == Deleted)
+            tombstones--;
+        ctrl[index] = (std::int8_t)(hash & 0x7F);
+        new (&slots[index]) value_type(std::move(element));
+        count++;
+        return &slots[index];
+    }
+
+    static std::size_t CapacityFor(std::size_t n)
+    {
+        std::size_t c = GroupSize;
+        while (c * 7 / 8 < n)
+            c *= 2;
+        return c;
+    }
+
+public:
+
+    FlatIntMap() {}
+    FlatIntMap(const FlatIntMap&) = delete;
+    FlatIntMap& operator=(const FlatIntMap&) = delete;
+
+    ~FlatIntMap()
+    {
+        for (std::size_t i = 0; i < capacity; i++)
+            if (ctrl[i] >= 0)
+                slots[i].~value_type();
+        delete[] ctrl;
+        ::operator delete(slots, std::align_val_t(alignof(value_type)));
+    }
+
+    std::size_t size() const { return count; }
+
+    void reserve(std::size_t n)
+    {
+        if (CapacityFor(n) > capacity)
+            Rehash(CapacityFor(n));
+    }
+
+    V* find(K key)
+    {
+        std::size_t i = FindIndex(key);
+        return i < capacity ? &slots[i].second : nullptr;
+    }
+
+    // Returns the element for `key` and whether it was newly inserted
+    template <typename... Args>
+    std::pair<V*, bool> emplace(K key, Args&&... args)
+    {
+        if (V* existing = find(key))
+            return { existing, false };
+
+        if (count + tombstones + 1 > capacity * 7 / 8)
+            Rehash(count + 1 > capacity * 7 / 16 ? CapacityFor(count + 1) * 2 : capacity);
+
+        value_type* element = InsertNew(value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                                   std::forward_as_tuple(std::forward<Args>(args)...)));
+        return { &element->second, true };
+    }
+
+    bool erase(K key)
+    {
+        std::size_t i = FindIndex(key);
+        if (i >= capacity)
+            return false;
+        slots[i].~value_type();
+        ctrl[i] = Deleted;
+        count--;
+        tombstones++;
+        return true;
+    }
+
+    template <typename F>
+    void for_each(F&& f)
+    {
+        for (std::size_t i = 0; i < capacity; i++)
+            if (ctrl[i] >= 0)
+                f(slots[i].first, slots[i].second);
+    }
+};
+
+void RunSample6()
+{
+    FlatIntMap<int, MyClass> objects;
+    for (int v : { 5, 10, 15, 10 })
+        objects.emplace(v, v);
+    objects.erase(15);
+    std::cout << "Objects: " << objects.size() << std::endl;
+    if (MyClass* found = objects.find(10))
+        found->print();
+
+    // Benchmark against std::unordered_map
+    const int n = 1 << 20;
+    std::mt19937 rng(11);
+    std::vector<int> keys(n);
+    for (int& k : keys)
+        k = (int)rng();
+
+    auto time = [](const char* label, auto&& body)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::size_t result = body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << label << elapsed.count() * 1e3 << " ms (" << result << ")" << std::endl;
+    };
+
+    {
+        std::unordered_map<int, MyClass> map;
+        time("unordered_map insert : ", [&] { map.reserve(n); for (int k : keys) map.emplace(k, k); return map.size(); });
+        time("unordered_map lookup : ", [&] { std::size_t hits = 0; for (int k : keys) hits += map.count(k) + map.count(k ^ 1); return hits; });
+        time("unordered_map erase  : ", [&] { for (int i = 0; i < n; i += 2) map.erase(keys[i]); return map.size(); });
+    }
+    {
+        FlatIntMap<int, MyClass> map;
+        time("FlatIntMap insert    : ", [&] { map.reserve(n); for (int k : keys) map.emplace(k, k); return map.size(); });
+        time("FlatIntMap lookup    : ", [&] { std::size_t hits = 0; for (int k : keys) hits += (map.find(k) != nullptr) + (map.find(k ^ 1) != nullptr); return hits; });
+        time("FlatIntMap erase     : ", [&] { for (int i = 0; i < n; i += 2) map.erase(keys[i]); return map.size(); });
+    }
+}
+
+// =================================
+//    Collections of mixed types
+// =================================
+
+/*
+    RunSample3 calls Display() through Base* pointers. With a large 
+    std::vector<Base*> holding Base and Derived objects in random order, every 
+    call jumps to a different function than the previous one, so the CPU keeps 
+    mispredicting the indirect branch, and the objects are scattered over the 
+    heap.
+
+    poly_collection<Base> keeps one contiguous segment (a std::vector) per 
+    dynamic type instead. Iterating visits all objects of one type, then the 
+    next type, so the virtual call target is the same for a whole segment and 
+    the objects are read sequentially.
+
+    for_each<Known...>(f) goes further: for the listed types it calls f with 
+    the concrete type (e.g. Derived&), so the compiler can resolve and inline 
+    the call; any other type is still visited through Base&.
+*/
+
+template <typename Base>
+class poly_collection
+{
+private:
+
+    struct SegmentBase
+    {
+        virtual ~SegmentBase() {}
+        virtual std::size_t Size() const = 0;
+
+        // visit(context, element) for every element, converted to Base&
+        virtual void ForEachBase(void (*visit)(void*, Base&), void* context) = 0;
+    };
+
+    template <typename T>
+    struct Segment : SegmentBase
+    {
+        std::vector<T> items;
+
+        std::size_t Size() const override { return items.size(); }
+
+        void ForEachBase(void (*visit)(void*, Base&), void* context) override
+        {
+            for (T& item : items)
+                visit(context, static_cast<Base&>(item));
+        }
+    };
+
+    std::vector<std::pair<std::type_index, std::unique_ptr<SegmentBase>>> segments;
+
+    template <typename T>
+    Segment<T>* Find()
+    {
+        for (auto& [type, segment] : segments)
+            if (type == typeid(T))
+                return static_cast<Segment<T>*>(segment.get());
+        return nullptr;
+    }
+
+    template <typename T>
+    Segment<T>& Get()
+    {
+        if (Segment<T>* segment = Find<T>())
+            return *segment;
+        segments.emplace_back(typeid(T), std::make_unique<Segment<T>>());
+        return static_cast<Segment<T>&>(*segments.back().second);
+    }
+
+    // One virtual call per segment; inside it `visit` is always the same 
+    // function, so the call per element is well predicted
+    template <typename F>
+    static void VisitAsBase(SegmentBase& segment, F& f)
+    {
+        segment.ForEachBase([](void* context, Base& obj) { (*static_cast<F*>(context))(obj); }, &f);
+    }
+
+public:
+
+    template <typename T>
+        requires std::is_base_of_v<Base, std::decay_t<T>>
+    void insert(T&& obj)
+    {
+        Get<std::decay_t<T>>().items.push_back(std::forward<T>(obj));
+    }
+
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args)
+    {
+        return Get<T>().items.emplace_back(std::forward<Args>(args)...);
+    }
+
+    std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (const auto& [type, segment] : segments)
+            total += segment->Size();
+        return total;
+    }
+
+    // f(Base&) for every object, one segment at a time
+    template <typename F>
+    void for_each(F&& f)
+    {
+        for (auto& [type, segment] : segments)
+            VisitAsBase(*segment, f);
+    }
+
+    // f(T&) with the concrete type for every T in Known..., f(Base&) otherwise
+    template <typename... Known, typename F>
+        requires (sizeof...(Known) > 0)
+    void for_each(F&& f)
+    {
+        for (auto& [type, segment] : segments)
+        {
+            bool handled = ((type == typeid(Known) ? (ForEachKnown<Known>(*segment, f), true) : false) || ...);
+            if (!handled)
+                VisitAsBase(*segment, f);
+        }
+    }
+
+private:
+
+    template <typename T, typename F>
+    static void ForEachKnown(SegmentBase& segment, F& f)
+    {
+        for (T& item : static_cast<Segment<T>&>(segment).items)
+            f(item);
+    }
+};
+
+// Final types let the compiler call Weight() directly once the type is known
+class Heavy final : public Base
+{
+public:
+    void Display() override { COUT("Heavy") }
+    int Weight() const override { return 3; }
+};
+
+class Light final : public Base
+{
+public:
+    void Display() override { COUT("Light") }
+    int Weight() const override { return 0; }
+};
+
+void RunSample7()
+{
+    poly_collection<Base> shapes;
+    shapes.emplace<Derived>();
+    shapes.emplace<Base>();
+    shapes.emplace<Derived>();
+    shapes.for_each([](Base& b) { b.Display(); });
+
+    // One million objects of four types in random order
+    const int n = 1 << 20;
+    std::mt19937 rng(3);
+    std::vector<std::unique_ptr<Base>> pointers;
+    poly_collection<Base> collection;
+    for (int i = 0; i < n; i++)
+    {
+        switch (rng() % 4)
+        {
+        case 0: pointers.push_back(std::make_unique<Base>());    collection.emplace<Base>();    break;
+        case 1: pointers.push_back(std::make_unique<Derived>()); collection.emplace<Derived>(); break;
+        case 2: pointers.push_back(std::make_unique<Heavy>());   collection.emplace<Heavy>();   break;
+        case 3: pointers.push_back(std::make_unique<Light>());   collection.emplace<Light>();   break;
+        }
+    }
+
+    const int reps = 10;
+    auto time = [&](const char* label, auto&& body)
+    {
+        long long total = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++)
+            total += body();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << label << elapsed.count() * 1e9 / (reps * (double)n) << " ns/object (" << total << ")" << std::endl;
+    };
+
+    time("vector<Base*>          : ", [&]
+    {
+        long long sum = 0;
+        for (const std::unique_ptr<Base>& p : pointers)
+            sum += p->Weight();
+        return sum;
+    });
+    time("poly_collection        : ", [&]
+    {
+        long long sum = 0;
+        collection.for_each([&](Base& b) { sum += b.Weight(); });
+        return sum;
+    });
+    time("poly_collection, known : ", [&]
+    {
+        long long sum = 0;
+        collection.for_each<Heavy, Light>([&](auto& b) { sum += b.Weight(); });
+        return sum;
+    });
+}
+
+// =================================
+//    Intrusive reference counting
+// =================================
+
+/*
+    std::shared_ptr keeps its reference count in a separate control block, and
+    always updates it atomically, even when only one thread ever uses it.
+
+    An intrusive pointer keeps the count inside the object itself: Base derives
+    from RefCounted<>, so every Base and Derived carries its own counter and 
+    intrusive_ptr is just a raw pointer that calls AddRef()/Release().
+    - RefCounted<RefCountMode::SingleThreaded> uses a plain int for objects 
+      that never cross threads, so copying a pointer is a plain increment.
+    - intrusive_ptr<Derived> converts to intrusive_ptr<Base> like a raw 
+      pointer; the count is the same one, so no extra bookkeeping is needed.
+    - The object is deleted through the pointer's static type, so a base class
+      needs a virtual destructor (Base has one).
+*/
+
+template <typename T>
+class intrusive_ptr
+{
+private:
+
+    T* ptr = nullptr;
+
+    template <typename U>
+    friend class intrusive_ptr;
+
+public:
+
+    intrusive_ptr() {}
+
+    explicit intrusive_ptr(T* p) : ptr(p)
+    {
+        if (ptr)
+            ptr->AddRef();
+    }
+
+    intrusive_ptr(const intrusive_ptr& other) : intrusive_ptr(other.ptr) {}
+
+    intrusive_ptr(intrusive_ptr&& other) noexcept : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    // Derived-to-base conversion
+    template <typename U>
+        requires std::is_convertible_v<U*, T*>
+    intrusive_ptr(const intrusive_ptr<U>& other) : intrusive_ptr(static_cast<T*>(other.ptr)) {}
+
+    template <typename U>
+        requires std::is_convertible_v<U*, T*>
+    intrusive_ptr(intrusive_ptr<U>&& other) noexcept : ptr(other.ptr)
+    {
+        other.ptr = nullptr;
+    }
+
+    ~intrusive_ptr()
+    {
+        if (ptr && ptr->Release())
+            delete ptr;
+    }
+
+    // Copy-and-swap also handles self-assignment
+    intrusive_ptr& operator=(intrusive_ptr other) noexcept
+    {
+        std::swap(ptr, other.ptr);
+        return *this;
+    }
+
+    void reset() { intrusive_ptr().swap(*this); }
+    void swap(intrusive_ptr& other) noexcept { std::swap(ptr, other.ptr); }
+
+    T* get() const { return ptr; }
+    T& operator*() const { return *ptr; }
+    T* operator->() const { return ptr; }
+    explicit operator bool() const { return ptr != nullptr; }
+
+    friend bool operator==(const intrusive_ptr& a, const intrusive_ptr& b) { return a.ptr == b.ptr; }
+};
+
+template <typename T, typename... Args>
+intrusive_ptr<T> make_intrusive(Args&&... args)
+{
+    return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+// Graph nodes for the benchmark; edges only point forward, so there are no cycles
+struct SharedNode
+{
+    int value = 0;
+    std::vector<std::shared_ptr<SharedNode>> edges;
+};
+
+template <RefCountMode Mode>
+struct IntrusiveNode : RefCounted<Mode>
+{
+    int value = 0;
+    std::vector<intrusive_ptr<IntrusiveNode>> edges;
+};
+
+// Builds n nodes with up to 4 forward edges each and returns the root
+template <typename Ptr, typename MakeNode>
+Ptr BuildGraph(int n, MakeNode make)
+{
+    std::vector<Ptr> nodes;
+    for (int i = 0; i < n; i++)
+    {
+        nodes.push_back(make());
+        nodes.back()->value = i;
+    }
+
+    std::mt19937 rng(17);
+    for (int i = 0; i < n - 1; i++)
+        for (int e = 0; e < 4; e++)
+            nodes[i]->edges.push_back(nodes[i + 1 + rng() % std::min(n - i - 1, 64)]);
+    return nodes[0];
+}
+
+// Random walk that copies a pointer at every step
+template <typename Ptr>
+long long Walk(const Ptr& root, int steps)
+{
+    std::mt19937 rng(23);
+    long long total = 0;
+    Ptr current = root;
+    for (int i = 0; i < steps; i++)
+    {
+        total += current->value;
+        Ptr next = current->edges.empty() ? root : current->edges[rng() % current->edges.size()];
+        current = next;
+    }
+    return total;
+}
+
+void RunSample8()
+{
+    intrusive_ptr<Derived> derived = make_intrusive<Derived>();
+    intrusive_ptr<Base> base = derived;
+    base->Display();
+    std::cout << "References: " << base->UseCount() << std::endl;
+
+    // Small enough to stay in cache, so the pointer copies dominate
+    const int nodes = 4000;
+    const int steps = 5000000;
+
+    auto time = [&](const char* label, auto&& walk)
+    {
+        auto start = std::chrono::steady_clock::now();
+        long long total = walk();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << label << elapsed.count() * 1e9 / steps << " ns/step (" << total << ")" << std::endl;
+    };
+
+    using Atomic = IntrusiveNode<RefCountMode::Atomic>;
+    using Single = IntrusiveNode<RefCountMode::SingleThreaded>;
+
+    auto sharedRoot = BuildGraph<std::shared_ptr<SharedNode>>(nodes, [] { return std::make_shared<SharedNode>(); });
+    auto atomicRoot = BuildGraph<intrusive_ptr<Atomic>>(nodes, [] { return make_intrusive<Atomic>(); });
+    auto singleRoot = BuildGraph<intrusive_ptr<Single>>(nodes, [] { return make_intrusive<Single>(); });
+
+    time("shared_ptr               : ", [&] { return Walk(sharedRoot, steps); });
+    time("intrusive_ptr (atomic)   : ", [&] { return Walk(atomicRoot, steps); });
+    time("intrusive_ptr (single)   : ", [&] { return Walk(singleRoot, steps); });
+}
+
 int main() 
 {
     COUT(">> Run Sample1")
@@ -143,5 +1479,20 @@ int main()
     COUT(">> Run Sample1")
     RunSample3();
 
+    COUT(">> Run Sample4")
+    RunSample4();
+
+    COUT(">> Run Sample5")
+    RunSample5();
+
+    COUT(">> Run Sample6")
+    RunSample6();
+
+    COUT(">> Run Sample7")
+    RunSample7();
+
+    COUT(">> Run Sample8")
+    RunSample8();
+
     return 0;
 }
@@ -1,4 +1,39 @@
 #include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numbers>
+#include <queue>
+#include <random>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
 /*
 	================================
@@ -45,13 +80,112 @@
 
 */
 
+/*
+	================================
+	|                              |
+	|   SCALAR TYPES FOR SHAPES    |
+	|                              |
+	================================
+
+	The shapes below are templates on the scalar type T used for their 
+	dimensions and area:
+	- double : the default (Shape, Circle and Rectangle are aliases for it).
+	- float  : half the memory, and twice as many values per SIMD register, 
+			   for screening passes where ~7 significant digits are enough.
+	- Fixed  : Q-format fixed point, for targets without an FPU or where 
+			   results must be bit-identical across platforms.
+
+	Pi<T> is pi rounded once to T, rather than an approximation like 3.14.
+*/
+
+// Q-format fixed point: stores value * 2^FracBits in a Rep integer
+template <int FracBits, typename Rep = std::int32_t>
+class Fixed
+{
+	static_assert(sizeof(Rep) <= 4, "products are computed in 64 bits");
+	static_assert(FracBits > 0 && FracBits < (int)sizeof(Rep) * 8 - 1);
+
+private:
+
+	static constexpr double One = double(std::int64_t(1) << FracBits);
+
+	Rep raw = 0;
+
+	// Converting a double that does not fit in Rep would be undefined
+	static constexpr Rep FromDouble(double v)
+	{
+		constexpr double lowest = std::numeric_limits<Rep>::min();
+		constexpr double highest = std::numeric_limits<Rep>::max();
+
+		double scaled = v * One + (v < 0 ? -0.5 : 0.5);
+		if (scaled != scaled)
+			return 0;
+		if (scaled <= lowest)
+			return std::numeric_limits<Rep>::min();
+		if (scaled >= highest)
+			return std::numeric_limits<Rep>::max();
+		return static_cast<Rep>(scaled);
+	}
+
+public:
+
+	constexpr Fixed() = default;
+
+	// Rounds to nearest; values outside the range saturate and NaN becomes 0
+	constexpr Fixed(double v) : raw(FromDouble(v))
+	{}
+
+	static constexpr Fixed FromRaw(Rep r)
+	{
+		Fixed f;
+		f.raw = r;
+		return f;
+	}
+
+	constexpr Rep Raw() const { return raw; }
+
+	explicit constexpr operator double() const { return raw / One; }
+
+	// Computed in 64 bits, then wrapped to Rep like integer arithmetic
+	friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw(Rep(std::int64_t(a.raw) + b.raw)); }
+	friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw(Rep(std::int64_t(a.raw) - b.raw)); }
+
+	// Full-width product, rounded back to FracBits
+	friend constexpr Fixed operator*(Fixed a, Fixed b)
+	{
+		std::int64_t product = std::int64_t(a.raw) * b.raw + (std::int64_t(1) << (FracBits - 1));
+		return FromRaw(Rep(product >> FracBits));
+	}
+
+	Fixed& operator+=(Fixed other) { return *this = *this + other; }
+
+	friend std::ostream& operator<<(std::ostream& os, Fixed f)
+	{
+		return os << double(f);
+	}
+};
+
+// Q16.16: range +/-32768, resolution ~1.5e-5
+using Q16 = Fixed<16>;
+
+// Pi correctly rounded to each scalar type
+template <typename T>
+inline constexpr T Pi = std::numbers::pi_v<T>;
+
+template <int FracBits, typename Rep>
+inline constexpr Fixed<FracBits, Rep> Pi<Fixed<FracBits, Rep>> = Fixed<FracBits, Rep>(std::numbers::pi);
+
 // Abstract Base Class with Pure Virtual Function
-class Shape 
+template <typename T>
+class BasicShape 
 {
 public:
 
+	// Deleting a derived shape through Shape* needs a virtual destructor
+	virtual ~BasicShape() {}
+
 	// Pure virtual function to calculate area
-	virtual double calculateArea() const = 0;
+	virtual T calculateArea() const = 0;
 
 	// Regular member function
 	void display() const 
@@ -61,26 +195,128 @@ public:
 };
 
 // Concrete Derived Class
-class Circle : public Shape 
+template <typename T>
+class BasicCircle : public BasicShape<T> 
 {
 private:
 
-	double radius;
+	T radius;
 
 public:
 
-	Circle(double r) : radius(r)
+	BasicCircle(T r) : radius(r)
 	{}
 
 	// Implementation of pure virtual function
-	double calculateArea() const override 
+	T calculateArea() const override 
+	{
+		return Pi<T> * radius * radius;
+	}
+
+	void resize(T r)
+	{
+		radius = r;
+	}
+
+	void scale(T factor)
 	{
-		return 3.14 * radius * radius;
+		radius = radius * factor;
 	}
 };
 
 // Concrete Derived Class
-class Rectangle : public Shape 
+template <typename T>
+class BasicRectangle : public BasicShape<T> 
+{
+private:
+
+	T length;
+	T width;
+
+public:
+
+	BasicRectangle(T l, T w) : length(l), width(w) 
+	{}
+
+	// Implementation of pure virtual function
+	T calculateArea() const override 
+	{
+		return length * width;
+	}
+
+	void resize(T l, T w)
+	{
+		length = l;
+		width = w;
+	}
+
+	void scale(T factor)
+	{
+		length = length * factor;
+		width = width * factor;
+	}
+};
+
+using Shape = BasicShape<double>;
+using Circle = BasicCircle<double>;
+using Rectangle = BasicRectangle<double>;
+
+/*
+	================================
+	|                              |
+	|  STATIC (COMPILE TIME) SHAPES|
+	|                              |
+	================================
+
+	A virtual call is decided at run time, so the compiler cannot inline 
+	calculateArea() into a loop over shapes, and the loop cannot be vectorized.
+	When every shape in a container has the same type, that flexibility is not 
+	needed.
+
+	The Curiously Recurring Template Pattern (CRTP) gives the same interface 
+	with compile time dispatch: StaticShape<Derived> calls 
+	Derived::calculateAreaImpl() directly, because it knows Derived as a 
+	template parameter. Algorithms written against the AreaShape concept 
+	(e.g. TotalArea) are then fully inlined for each concrete type.
+
+	VirtualShape<S> adapts any static shape back to the virtual Shape 
+	interface, for the places where runtime polymorphism is needed.
+*/
+
+template <typename Derived>
+class StaticShape
+{
+public:
+
+	double calculateArea() const
+	{
+		return static_cast<const Derived&>(*this).calculateAreaImpl();
+	}
+
+	void display() const
+	{
+		std::cout << "This is a shape." << std::endl;
+	}
+};
+
+class StaticCircle : public StaticShape<StaticCircle>
+{
+private:
+
+	double radius;
+
+public:
+
+	StaticCircle(double r) : radius(r)
+	{}
+
+	double calculateAreaImpl() const
+	{
+		return Pi<double> * radius * radius;
+	}
+};
+
+class StaticRectangle : public StaticShape<StaticRectangle>
 {
 private:
 
@@ -89,28 +325,1913 @@ private:
 
 public:
 
-	Rectangle(double l, double w) : length(l), width(w) 
+	StaticRectangle(double l, double w) : length(l), width(w)
 	{}
 
-	// Implementation of pure virtual function
-	double calculateArea() const override 
+	double calculateAreaImpl() const
 	{
 		return length * width;
 	}
 };
 
-int main() {
+// Anything with a const calculateArea() returning a number
+template <typename S>
+concept AreaShape = requires(const S& s)
+{
+	{ s.calculateArea() } -> std::convertible_to<double>;
+};
 
-	// Shape shape; // Error: Cannot create instance of an abstract class
+// Inlined for each concrete shape type; independent partial sums let the
+// compiler vectorize the loop without reordering a single running total
+template <AreaShape S>
+double TotalArea(std::span<const S> shapes)
+{
+	constexpr std::size_t Lanes = 4;
+	double partial[Lanes] = {};
 
-	Circle circle(5);
-	Rectangle rectangle(4, 6);
+	std::size_t i = 0;
+	for (; i + Lanes <= shapes.size(); i += Lanes)
+		for (std::size_t j = 0; j < Lanes; j++)
+			partial[j] += shapes[i + j].calculateArea();
+
+	double total = 0;
+	for (; i < shapes.size(); i++)
+		total += shapes[i].calculateArea();
+	return total + (partial[0] + partial[1]) + (partial[2] + partial[3]);
+}
+
+// Same algorithm through the virtual interface
+double TotalArea(std::span<const Shape* const> shapes)
+{
+	double total = 0;
+	for (const Shape* shape : shapes)
+		total += shape->calculateArea();
+	return total;
+}
+
+// Wraps a static shape so it can be used as a Shape*
+template <AreaShape S>
+class VirtualShape : public Shape
+{
+private:
+
+	S shape;
+
+public:
+
+	VirtualShape(const S& s) : shape(s)
+	{}
+
+	double calculateArea() const override
+	{
+		return shape.calculateArea();
+	}
+};
+
+void RunStaticSample()
+{
+	StaticCircle circle(5);
+	StaticRectangle rectangle(4, 6);
 
 	circle.display();
-	std::cout << "Area of Circle: " << circle.calculateArea() << std::endl;
+	std::cout << "Area of StaticCircle: " << circle.calculateArea() << std::endl;
+	std::cout << "Area of StaticRectangle: " << rectangle.calculateArea() << std::endl;
 
-	rectangle.display();
-	std::cout << "Area of Rectangle: " << rectangle.calculateArea() << std::endl;
+	// Plugging a static shape into the virtual interface
+	VirtualShape<StaticCircle> adapted(circle);
+	const Shape& shape = adapted;
+	std::cout << "Through Shape&: " << shape.calculateArea() << std::endl;
+
+	// Benchmark: the same circles through Shape* and as StaticCircle
+	const std::size_t n = 1 << 20;
+	const int reps = 20;
+	std::vector<Circle> circles;
+	std::vector<const Shape*> pointers;
+	std::vector<StaticCircle> staticCircles;
+	circles.reserve(n);
+	for (std::size_t i = 0; i < n; i++)
+	{
+		circles.emplace_back(1.0 + (i % 100) * 0.01);
+		staticCircles.emplace_back(1.0 + (i % 100) * 0.01);
+	}
+	for (const Circle& c : circles)
+		pointers.push_back(&c);
+
+	auto time = [&](const char* label, auto&& body)
+	{
+		double total = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < reps; r++)
+			total += body();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << label << elapsed.count() * 1e9 / (reps * (double)n) << " ns/shape (" << total << ")" << std::endl;
+	};
+
+	time("virtual Shape*  : ", [&] { return TotalArea(std::span<const Shape* const>(pointers)); });
+	time("CRTP StaticShape: ", [&] { return TotalArea(std::span<const StaticCircle>(staticCircles)); });
+}
+
+/*
+	================================
+	|                              |
+	|     BATCH AREA KERNELS       |
+	|                              |
+	================================
+
+	CircleAreas and RectangleAreas compute many areas at once from arrays of 
+	dimensions (structure of arrays). They are written against ShapeLanes<T>:
+	with AVX, a 256-bit register holds 8 floats but only 4 doubles, so the 
+	float kernels do twice the work per instruction and read half the bytes. 
+	Other types (including Fixed) fall back to one element at a time. All 
+	spans passed to one call must have the same size (std::invalid_argument 
+	otherwise).
+*/
+
+template <typename T>
+struct ShapeLanes
+{
+	static constexpr std::size_t Width = 1;
+
+	using Reg = T;
+
+	static Reg Load(const T* p) { return *p; }
+	static void Store(T* p, Reg v) { *p = v; }
+	static Reg Broadcast(T v) { return v; }
+	static Reg Mul(Reg a, Reg b) { return a * b; }
+};
+
+#if defined(__AVX__)
+
+template <>
+struct ShapeLanes<float>
+{
+	static constexpr std::size_t Width = 8;
+
+	using Reg = __m256;
+
+	static Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+	static Reg Broadcast(float v) { return _mm256_set1_ps(v); }
+	static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+};
+
+template <>
+struct ShapeLanes<double>
+{
+	static constexpr std::size_t Width = 4;
+
+	using Reg = __m256d;
+
+	static Reg Load(const double* p) { return _mm256_loadu_pd(p); }
+	static void Store(double* p, Reg v) { _mm256_storeu_pd(p, v); }
+	static Reg Broadcast(double v) { return _mm256_set1_pd(v); }
+	static Reg Mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+};
+
+#endif
+
+// areas[i] = Pi<T> * radii[i] * radii[i]
+template <typename T>
+void CircleAreas(std::span<const T> radii, std::span<T> areas)
+{
+	if (areas.size() != radii.size())
+		throw std::invalid_argument("CircleAreas: span sizes do not match");
+
+	using L = ShapeLanes<T>;
+	const typename L::Reg pi = L::Broadcast(Pi<T>);
+	const std::size_t n = radii.size();
+	const std::size_t full = n - n % L::Width;
+
+	std::size_t i = 0;
+	for (; i < full; i += L::Width)
+	{
+		typename L::Reg r = L::Load(radii.data() + i);
+		L::Store(areas.data() + i, L::Mul(L::Mul(pi, r), r));
+	}
+	for (; i < n; i++)
+		areas[i] = Pi<T> * radii[i] * radii[i];
+}
+
+// areas[i] = lengths[i] * widths[i]
+template <typename T>
+void RectangleAreas(std::span<const T> lengths, std::span<const T> widths, std::span<T> areas)
+{
+	if (widths.size() != lengths.size() || areas.size() != lengths.size())
+		throw std::invalid_argument("RectangleAreas: span sizes do not match");
+
+	using L = ShapeLanes<T>;
+	const std::size_t n = lengths.size();
+	const std::size_t full = n - n % L::Width;
+
+	std::size_t i = 0;
+	for (; i < full; i += L::Width)
+		L::Store(areas.data() + i, L::Mul(L::Load(lengths.data() + i), L::Load(widths.data() + i)));
+	for (; i < n; i++)
+		areas[i] = lengths[i] * widths[i];
+}
+
+template <typename T>
+void ShowPrecision(const char* label)
+{
+	BasicCircle<T> circle(5);
+	T area = circle.calculateArea();
+	double error = std::abs(double(area) - 25 * std::numbers::pi);
+	std::cout << label << "area " << area << ", error " << error << ", " << sizeof(T) << " bytes" << std::endl;
+}
+
+void RunPrecisionSample()
+{
+	// Circle of radius 5 at each precision
+	ShowPrecision<float>("float : ");
+	ShowPrecision<double>("double: ");
+	ShowPrecision<Q16>("Q16   : ");
+
+	// Benchmark: the same radii as float and as double
+	const std::size_t n = 1 << 20;
+	const int reps = 50;
+
+	auto time = [&]<typename T>(const char* label, std::vector<T>& radii, std::vector<T>& areas)
+	{
+		double checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int r = 0; r < reps; r++)
+		{
+			CircleAreas<T>(radii, areas);
+			checksum += double(areas[r]);
+		}
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << label << elapsed.count() * 1e9 / (reps * (double)n) << " ns/circle, "
+				  << 2 * n * sizeof(T) / 1024 << " KiB (" << checksum << ")" << std::endl;
+	};
+
+	std::vector<float> radiiF(n), areasF(n);
+	std::vector<double> radiiD(n), areasD(n);
+	for (std::size_t i = 0; i < n; i++)
+	{
+		radiiD[i] = 1.0 + (i % 100) * 0.01;
+		radiiF[i] = float(radiiD[i]);
+	}
+
+	time("CircleAreas<float> : ", radiiF, areasF);
+	time("CircleAreas<double>: ", radiiD, areasD);
+}
+
+/*
+	================================
+	|                              |
+	|   POSITIONED SHAPES AND      |
+	|   INTERSECTION (2-D TABLE)   |
+	|                              |
+	================================
+
+	Whether two shapes intersect depends on the concrete type of *both* of 
+	them (double dispatch). A virtual function only selects on one object, 
+	and probing the other with a chain of dynamic_cast is slow: every cast 
+	walks the RTTI of the class hierarchy.
+
+	Instead, every PlacedShape stores a compact ShapeKind id (0, 1, ...), and 
+	IntersectTable[a.Kind()][b.Kind()] holds a pointer to the function for 
+	that pair of types. One call is two array loads and one indirect call; 
+	the static_cast inside each entry is free because the kind is known.
+
+	For many shapes at once, IntersectingPairs groups the shapes by kind and 
+	runs a typed loop for each pair of groups, so the table is consulted 
+	once per group pair and the intersection tests are inlined.
+*/
+
+enum class ShapeKind : std::uint8_t
+{
+	Circle,
+	Rectangle,
+};
+
+inline constexpr std::size_t ShapeKindCount = 2;
+
+struct Point
+{
+	double x;
+	double y;
+};
+
+// A shape with a position in the plane and a type id for double dispatch
+class PlacedShape : public Shape
+{
+private:
+
+	ShapeKind kind;
+
+protected:
+
+	PlacedShape(ShapeKind k) : kind(k)
+	{}
+
+public:
+
+	ShapeKind Kind() const { return kind; }
+};
+
+class PlacedCircle : public PlacedShape
+{
+private:
+
+	Point center;
+	double radius;
+
+public:
+
+	static constexpr ShapeKind StaticKind = ShapeKind::Circle;
+
+	PlacedCircle(Point c, double r) : PlacedShape(StaticKind), center(c), radius(r)
+	{}
+
+	double calculateArea() const override
+	{
+		return Pi<double> * radius * radius;
+	}
+
+	Point Center() const { return center; }
+	double Radius() const { return radius; }
+};
+
+// Axis aligned: length along x, width along y, from the lower-left corner
+class PlacedRectangle : public PlacedShape
+{
+private:
+
+	Point corner;
+	double length;
+	double width;
+
+public:
+
+	static constexpr ShapeKind StaticKind = ShapeKind::Rectangle;
+
+	PlacedRectangle(Point c, double l, double w) : PlacedShape(StaticKind), corner(c), length(l), width(w)
+	{}
+
+	double calculateArea() const override
+	{
+		return length * width;
+	}
+
+	Point Min() const { return corner; }
+	Point Max() const { return { corner.x + length, corner.y + width }; }
+};
+
+// Shapes are closed: touching counts as intersecting
+inline bool Intersects(const PlacedCircle& a, const PlacedCircle& b)
+{
+	double dx = a.Center().x - b.Center().x;
+	double dy = a.Center().y - b.Center().y;
+	double r = a.Radius() + b.Radius();
+	return dx * dx + dy * dy <= r * r;
+}
+
+inline bool Intersects(const PlacedCircle& c, const PlacedRectangle& r)
+{
+	// Distance from the centre to the closest point of the rectangle
+	double dx = c.Center().x - std::clamp(c.Center().x, r.Min().x, r.Max().x);
+	double dy = c.Center().y - std::clamp(c.Center().y, r.Min().y, r.Max().y);
+	return dx * dx + dy * dy <= c.Radius() * c.Radius();
+}
+
+inline bool Intersects(const PlacedRectangle& r, const PlacedCircle& c)
+{
+	return Intersects(c, r);
+}
+
+inline bool Intersects(const PlacedRectangle& a, const PlacedRectangle& b)
+{
+	return a.Min().x <= b.Max().x && b.Min().x <= a.Max().x
+		&& a.Min().y <= b.Max().y && b.Min().y <= a.Max().y;
+}
+
+using IntersectFn = bool (*)(const PlacedShape&, const PlacedShape&);
+
+template <typename A, typename B>
+bool IntersectsAs(const PlacedShape& a, const PlacedShape& b)
+{
+	return Intersects(static_cast<const A&>(a), static_cast<const B&>(b));
+}
+
+// Row: kind of the first shape, column: kind of the second
+inline constexpr IntersectFn IntersectTable[ShapeKindCount][ShapeKindCount] =
+{
+	{ IntersectsAs<PlacedCircle, PlacedCircle>,    IntersectsAs<PlacedCircle, PlacedRectangle>    },
+	{ IntersectsAs<PlacedRectangle, PlacedCircle>, IntersectsAs<PlacedRectangle, PlacedRectangle> },
+};
+
+static_assert(std::size_t(PlacedCircle::StaticKind) == 0 && std::size_t(PlacedRectangle::StaticKind) == 1,
+			  "IntersectTable rows and columns follow ShapeKind");
+
+inline bool Intersects(const PlacedShape& a, const PlacedShape& b)
+{
+	return IntersectTable[std::size_t(a.Kind())][std::size_t(b.Kind())](a, b);
+}
+
+// Indices of two intersecting shapes, first < second
+struct ShapePair
+{
+	std::uint32_t first;
+	std::uint32_t second;
+
+	friend bool operator==(const ShapePair&, const ShapePair&) = default;
+	friend auto operator<=>(const ShapePair&, const ShapePair&) = default;
+};
+
+// Tests every shape of group a against every shape of group b, inlined for 
+// the concrete types A and B. When the groups are the same, only j > i.
+template <typename A, typename B>
+void IntersectGroups(std::span<const PlacedShape* const> shapes,
+					 std::span<const std::uint32_t> a, std::span<const std::uint32_t> b,
+					 bool sameGroup, std::vector<ShapePair>& out)
+{
+	for (std::size_t i = 0; i < a.size(); i++)
+	{
+		const A& first = static_cast<const A&>(*shapes[a[i]]);
+		for (std::size_t j = sameGroup ? i + 1 : 0; j < b.size(); j++)
+		{
+			if (Intersects(first, static_cast<const B&>(*shapes[b[j]])))
+				out.push_back({ std::min(a[i], b[j]), std::max(a[i], b[j]) });
+		}
+	}
+}
+
+using IntersectGroupsFn = void (*)(std::span<const PlacedShape* const>,
+								   std::span<const std::uint32_t>, std::span<const std::uint32_t>,
+								   bool, std::vector<ShapePair>&);
+
+inline constexpr IntersectGroupsFn IntersectGroupsTable[ShapeKindCount][ShapeKindCount] =
+{
+	{ IntersectGroups<PlacedCircle, PlacedCircle>,    IntersectGroups<PlacedCircle, PlacedRectangle>    },
+	{ IntersectGroups<PlacedRectangle, PlacedCircle>, IntersectGroups<PlacedRectangle, PlacedRectangle> },
+};
+
+// All-pairs mode: every intersecting pair, sorted
+std::vector<ShapePair> IntersectingPairs(std::span<const PlacedShape* const> shapes)
+{
+	std::vector<std::uint32_t> groups[ShapeKindCount];
+	for (std::uint32_t i = 0; i < shapes.size(); i++)
+		groups[std::size_t(shapes[i]->Kind())].push_back(i);
+
+	std::vector<ShapePair> out;
+	for (std::size_t ka = 0; ka < ShapeKindCount; ka++)
+		for (std::size_t kb = ka; kb < ShapeKindCount; kb++)
+			IntersectGroupsTable[ka][kb](shapes, groups[ka], groups[kb], ka == kb, out);
+
+	std::sort(out.begin(), out.end());
+	return out;
+}
+
+// Candidate-pairs mode: keeps the candidates (e.g. from a broad phase) that 
+// really intersect, in their original order
+std::vector<ShapePair> IntersectingPairs(std::span<const PlacedShape* const> shapes,
+										 std::span<const ShapePair> candidates)
+{
+	std::vector<ShapePair> out;
+	for (const ShapePair& pair : candidates)
+	{
+		if (Intersects(*shapes[pair.first], *shapes[pair.second]))
+			out.push_back(pair);
+	}
+	return out;
+}
+
+// What the table replaces: probing both types with dynamic_cast
+bool IntersectsRtti(const Shape& a, const Shape& b)
+{
+	if (auto* ca = dynamic_cast<const PlacedCircle*>(&a))
+	{
+		if (auto* cb = dynamic_cast<const PlacedCircle*>(&b))
+			return Intersects(*ca, *cb);
+		if (auto* rb = dynamic_cast<const PlacedRectangle*>(&b))
+			return Intersects(*ca, *rb);
+	}
+	else if (auto* ra = dynamic_cast<const PlacedRectangle*>(&a))
+	{
+		if (auto* cb = dynamic_cast<const PlacedCircle*>(&b))
+			return Intersects(*ra, *cb);
+		if (auto* rb = dynamic_cast<const PlacedRectangle*>(&b))
+			return Intersects(*ra, *rb);
+	}
+	return false;
+}
+
+void RunIntersectionSample()
+{
+	PlacedCircle circle({ 0, 0 }, 5);
+	PlacedRectangle rectangle({ 3, 3 }, 4, 6);
+	PlacedRectangle farAway({ 100, 100 }, 1, 1);
+
+	std::cout << "circle & rectangle: " << Intersects(circle, rectangle) << std::endl;
+	std::cout << "circle & farAway  : " << Intersects(circle, farAway) << std::endl;
+
+	// Random mix of circles and rectangles in a 1000 x 1000 square
+	const std::size_t n = 2000;
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<double> position(0, 1000), size(1, 20);
+
+	std::vector<PlacedCircle> circles;
+	std::vector<PlacedRectangle> rectangles;
+	for (std::size_t i = 0; i < n / 2; i++)
+	{
+		circles.emplace_back(Point{ position(rng), position(rng) }, size(rng));
+		rectangles.emplace_back(Point{ position(rng), position(rng) }, size(rng), size(rng));
+	}
+
+	std::vector<const PlacedShape*> shapes;
+	for (std::size_t i = 0; i < n / 2; i++)
+	{
+		shapes.push_back(&circles[i]);
+		shapes.push_back(&rectangles[i]);
+	}
+	std::shuffle(shapes.begin(), shapes.end(), rng);
+
+	auto time = [&](const char* label, auto&& body)
+	{
+		auto start = std::chrono::steady_clock::now();
+		std::size_t hits = body();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		double pairs = n * (n - 1) / 2.0;
+		std::cout << label << elapsed.count() * 1e9 / pairs << " ns/pair (" << hits << " hits)" << std::endl;
+	};
+
+	time("dynamic_cast     : ", [&]
+	{
+		std::size_t hits = 0;
+		for (std::size_t i = 0; i < n; i++)
+			for (std::size_t j = i + 1; j < n; j++)
+				hits += IntersectsRtti(*shapes[i], *shapes[j]);
+		return hits;
+	});
+	time("IntersectTable   : ", [&]
+	{
+		std::size_t hits = 0;
+		for (std::size_t i = 0; i < n; i++)
+			for (std::size_t j = i + 1; j < n; j++)
+				hits += Intersects(*shapes[i], *shapes[j]);
+		return hits;
+	});
+	time("IntersectingPairs: ", [&] { return IntersectingPairs(shapes).size(); });
+}
+
+/*
+	================================
+	|                              |
+	|       SPATIAL INDEXES        |
+	|                              |
+	================================
+
+	Answering "which shapes contain this point / overlap this window / are 
+	nearest to here" by scanning every shape costs O(n) per query. A spatial 
+	index keeps the bounding Box of every shape in a structure that can skip 
+	whole regions of the plane:
+
+	- UniformGrid: the bounds are cut into equal cells, and each cell lists 
+	  the shapes overlapping it. Very fast when shapes are spread evenly, but 
+	  crowded cells (skewed data) degrade it towards a scan.
+	- RTree: a tree of nested boxes, built bottom-up in one pass with the 
+	  Sort-Tile-Recursive (STR) method: sort by x, cut into vertical slices, 
+	  sort each slice by y, and pack Fanout boxes per node. Nodes adapt to 
+	  where the data actually is, so skewed data is handled well.
+
+	Both offer the same queries, return shape indices (positions in the span 
+	they were built from), and test the exact shape only after its box 
+	passes. Both are immutable once built.
+*/
+
+struct Box
+{
+	Point min;
+	Point max;
+};
+
+inline bool Overlaps(const Box& a, const Box& b)
+{
+	return a.min.x <= b.max.x && b.min.x <= a.max.x
+		&& a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+inline bool Contains(const Box& b, Point p)
+{
+	return b.min.x <= p.x && p.x <= b.max.x && b.min.y <= p.y && p.y <= b.max.y;
+}
+
+// 0 when p is inside
+inline double Distance(const Box& b, Point p)
+{
+	double dx = std::max({ b.min.x - p.x, 0.0, p.x - b.max.x });
+	double dy = std::max({ b.min.y - p.y, 0.0, p.y - b.max.y });
+	return std::hypot(dx, dy);
+}
+
+inline Box Union(const Box& a, const Box& b)
+{
+	return { { std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y) },
+			 { std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y) } };
+}
+
+inline Point Center(const Box& b)
+{
+	return { (b.min.x + b.max.x) / 2, (b.min.y + b.max.y) / 2 };
+}
+
+inline Box Bounds(const PlacedCircle& c)
+{
+	double r = c.Radius();
+	return { { c.Center().x - r, c.Center().y - r }, { c.Center().x + r, c.Center().y + r } };
+}
+
+inline Box Bounds(const PlacedRectangle& r)
+{
+	return { r.Min(), r.Max() };
+}
+
+inline bool Contains(const PlacedCircle& c, Point p)
+{
+	double dx = p.x - c.Center().x;
+	double dy = p.y - c.Center().y;
+	return dx * dx + dy * dy <= c.Radius() * c.Radius();
+}
+
+inline bool Contains(const PlacedRectangle& r, Point p)
+{
+	return Contains(Bounds(r), p);
+}
+
+inline double Distance(const PlacedCircle& c, Point p)
+{
+	return std::max(0.0, std::hypot(p.x - c.Center().x, p.y - c.Center().y) - c.Radius());
+}
+
+inline double Distance(const PlacedRectangle& r, Point p)
+{
+	return Distance(Bounds(r), p);
+}
+
+// Calls f with the concrete type of a placed shape
+template <typename F>
+decltype(auto) VisitPlaced(const PlacedShape& shape, F&& f)
+{
+	if (shape.Kind() == ShapeKind::Circle)
+		return f(static_cast<const PlacedCircle&>(shape));
+	return f(static_cast<const PlacedRectangle&>(shape));
+}
+
+inline Box Bounds(const PlacedShape& shape)
+{
+	return VisitPlaced(shape, [](const auto& s) { return Bounds(s); });
+}
+
+inline bool Contains(const PlacedShape& shape, Point p)
+{
+	return VisitPlaced(shape, [p](const auto& s) { return Contains(s, p); });
+}
+
+inline double Distance(const PlacedShape& shape, Point p)
+{
+	return VisitPlaced(shape, [p](const auto& s) { return Distance(s, p); });
+}
+
+// Window queries reuse the exact rectangle intersection tests
+inline PlacedRectangle ToRectangle(const Box& b)
+{
+	return PlacedRectangle(b.min, b.max.x - b.min.x, b.max.y - b.min.y);
+}
+
+struct Neighbor
+{
+	std::uint32_t id;
+	double distance;
+};
+
+class UniformGrid
+{
+private:
+
+	std::vector<const PlacedShape*> shapes;
+	std::vector<Box> boxes;
+
+	Box bounds{};
+	double cellWidth = 1;
+	double cellHeight = 1;
+	int cols = 1;
+	int rows = 1;
+
+	// Shapes of cell c are cellItems[cellStart[c] .. cellStart[c + 1])
+	std::vector<std::uint32_t> cellStart;
+	std::vector<std::uint32_t> cellItems;
+
+	int Col(double x) const { return int(std::clamp((x - bounds.min.x) / cellWidth, 0.0, cols - 1.0)); }
+	int Row(double y) const { return int(std::clamp((y - bounds.min.y) / cellHeight, 0.0, rows - 1.0)); }
+	int Cell(int col, int row) const { return row * cols + col; }
+
+	template <typename F>
+	void ForEachCell(const Box& b, F&& f) const
+	{
+		for (int row = Row(b.min.y); row <= Row(b.max.y); row++)
+			for (int col = Col(b.min.x); col <= Col(b.max.x); col++)
+				f(col, row);
+	}
+
+public:
+
+	// Sized for about itemsPerCell shapes per cell
+	explicit UniformGrid(std::span<const PlacedShape* const> s, double itemsPerCell = 2)
+		: shapes(s.begin(), s.end())
+	{
+		if (shapes.empty())
+		{
+			cellStart.assign(2, 0);
+			return;
+		}
+
+		bounds = Bounds(*shapes[0]);
+		for (const PlacedShape* shape : shapes)
+		{
+			boxes.push_back(Bounds(*shape));
+			bounds = Union(bounds, boxes.back());
+		}
+
+		cols = rows = std::max(1, int(std::sqrt(shapes.size() / itemsPerCell)));
+		cellWidth = std::max(bounds.max.x - bounds.min.x, 1e-9) / cols;
+		cellHeight = std::max(bounds.max.y - bounds.min.y, 1e-9) / rows;
+
+		// Count, prefix sum, then fill (compressed sparse rows)
+		cellStart.assign(std::size_t(cols) * rows + 1, 0);
+		for (const Box& b : boxes)
+			ForEachCell(b, [&](int col, int row) { cellStart[Cell(col, row) + 1]++; });
+		for (std::size_t c = 1; c < cellStart.size(); c++)
+			cellStart[c] += cellStart[c - 1];
+
+		std::vector<std::uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+		cellItems.resize(cellStart.back());
+		for (std::uint32_t id = 0; id < boxes.size(); id++)
+			ForEachCell(boxes[id], [&](int col, int row) { cellItems[fill[Cell(col, row)]++] = id; });
+	}
+
+	// Shapes containing p
+	std::vector<std::uint32_t> QueryPoint(Point p) const
+	{
+		std::vector<std::uint32_t> out;
+		if (shapes.empty() || !Contains(bounds, p))
+			return out;
+
+		int c = Cell(Col(p.x), Row(p.y));
+		for (std::uint32_t k = cellStart[c]; k < cellStart[c + 1]; k++)
+		{
+			std::uint32_t id = cellItems[k];
+			if (Contains(boxes[id], p) && Contains(*shapes[id], p))
+				out.push_back(id);
+		}
+		return out;
+	}
+
+	// Shapes intersecting the window
+	std::vector<std::uint32_t> QueryWindow(const Box& window) const
+	{
+		std::vector<std::uint32_t> out;
+		if (shapes.empty() || !Overlaps(bounds, window))
+			return out;
+
+		PlacedRectangle rectangle = ToRectangle(window);
+		ForEachCell(window, [&](int col, int row)
+		{
+			int c = Cell(col, row);
+			for (std::uint32_t k = cellStart[c]; k < cellStart[c + 1]; k++)
+			{
+				std::uint32_t id = cellItems[k];
+				const Box& b = boxes[id];
+				if (!Overlaps(b, window))
+					continue;
+
+				// A shape spanning several cells is reported only from the 
+				// cell holding the lower-left corner of its overlap with the window
+				if (Col(std::max(b.min.x, window.min.x)) != col || Row(std::max(b.min.y, window.min.y)) != row)
+					continue;
+
+				if (Intersects(*shapes[id], rectangle))
+					out.push_back(id);
+			}
+		});
+		return out;
+	}
+
+	// The k shapes closest to p, nearest first. Cells are visited in square 
+	// rings around p until no unvisited cell can hold a closer shape.
+	std::vector<Neighbor> Nearest(Point p, std::size_t k) const
+	{
+		std::vector<Neighbor> best;
+		if (shapes.empty() || k == 0)
+			return best;
+
+		auto farther = [](const Neighbor& a, const Neighbor& b) { return a.distance < b.distance; };
+		auto consider = [&](std::uint32_t id)
+		{
+			bool full = best.size() == k;
+			if (full && Distance(boxes[id], p) >= best.front().distance)
+				return;
+
+			// Shapes spanning several cells are met more than once; k is small
+			for (const Neighbor& n : best)
+				if (n.id == id)
+					return;
+
+			double d = Distance(*shapes[id], p);
+			if (full && d >= best.front().distance)
+				return;
+			if (full)
+			{
+				std::pop_heap(best.begin(), best.end(), farther);
+				best.pop_back();
+			}
+			best.push_back({ id, d });
+			std::push_heap(best.begin(), best.end(), farther);
+		};
+
+		const int pc = Col(p.x);
+		const int pr = Row(p.y);
+		const double cellMin = std::min(cellWidth, cellHeight);
+		const int maxRing = std::max(cols, rows);
+
+		for (int ring = 0; ring <= maxRing; ring++)
+		{
+			// Unvisited cells are at least (ring - 1) cells away from p
+			if (best.size() == k && best.front().distance <= (ring - 1) * cellMin)
+				break;
+
+			for (int row = std::max(pr - ring, 0); row <= std::min(pr + ring, rows - 1); row++)
+			{
+				bool edgeRow = row == pr - ring || row == pr + ring;
+				int step = edgeRow ? 1 : 2 * ring;
+				for (int col = pc - ring; col <= pc + ring; col += std::max(step, 1))
+				{
+					if (col < 0 || col >= cols)
+						continue;
+					int c = Cell(col, row);
+					for (std::uint32_t i = cellStart[c]; i < cellStart[c + 1]; i++)
+						consider(cellItems[i]);
+				}
+			}
+		}
+
+		std::sort_heap(best.begin(), best.end(), farther);
+		return best;
+	}
+};
+
+class RTree
+{
+private:
+
+	static constexpr std::size_t Fanout = 16;
+
+	// Children of a leaf are order[first .. first + count), of an inner 
+	// node nodes[first .. first + count)
+	struct Node
+	{
+		Box box;
+		std::uint32_t first;
+		std::uint32_t count;
+		bool leaf;
+	};
+
+	std::vector<const PlacedShape*> shapes;
+	std::vector<Box> boxes;
+	std::vector<std::uint32_t> order;
+	std::vector<Node> nodes;    // bottom level first, root last
+
+	// Sort-Tile-Recursive ordering of one level
+	template <typename T, typename BoxOf>
+	static void SortTiles(std::vector<T>& items, BoxOf boxOf)
+	{
+		auto byX = [&](const T& a, const T& b) { return Center(boxOf(a)).x < Center(boxOf(b)).x; };
+		auto byY = [&](const T& a, const T& b) { return Center(boxOf(a)).y < Center(boxOf(b)).y; };
+
+		std::size_t pages = (items.size() + Fanout - 1) / Fanout;
+		std::size_t slices = std::size_t(std::ceil(std::sqrt(double(pages))));
+		std::size_t sliceSize = slices * Fanout;
+
+		std::sort(items.begin(), items.end(), byX);
+		for (std::size_t i = 0; i < items.size(); i += sliceSize)
+			std::sort(items.begin() + i, items.begin() + std::min(i + sliceSize, items.size()), byY);
+	}
+
+	// One parent per Fanout consecutive children
+	template <typename BoxOf>
+	static std::vector<Node> Pack(std::size_t count, std::uint32_t base, bool leaf, BoxOf boxOf)
+	{
+		std::vector<Node> parents;
+		for (std::size_t i = 0; i < count; i += Fanout)
+		{
+			Node node{ boxOf(i), std::uint32_t(base + i), std::uint32_t(std::min(Fanout, count - i)), leaf };
+			for (std::size_t j = 1; j < node.count; j++)
+				node.box = Union(node.box, boxOf(i + j));
+			parents.push_back(node);
+		}
+		return parents;
+	}
+
+	// Visits every shape whose box, and all of whose ancestors' boxes, pass
+	template <typename BoxTest, typename Visit>
+	void Search(BoxTest test, Visit visit) const
+	{
+		if (nodes.empty() || !test(nodes.back().box))
+			return;
+
+		std::vector<std::uint32_t> stack{ std::uint32_t(nodes.size() - 1) };
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				if (node.leaf)
+				{
+					if (test(boxes[order[i]]))
+						visit(order[i]);
+				}
+				else if (test(nodes[i].box))
+					stack.push_back(i);
+			}
+		}
+	}
+
+public:
+
+	explicit RTree(std::span<const PlacedShape* const> s) : shapes(s.begin(), s.end())
+	{
+		for (const PlacedShape* shape : shapes)
+			boxes.push_back(Bounds(*shape));
+		if (shapes.empty())
+			return;
+
+		order.resize(shapes.size());
+		for (std::uint32_t id = 0; id < order.size(); id++)
+			order[id] = id;
+		SortTiles(order, [&](std::uint32_t id) { return boxes[id]; });
+
+		std::vector<Node> level = Pack(order.size(), 0, true, [&](std::size_t i) { return boxes[order[i]]; });
+		while (level.size() > 1)
+		{
+			SortTiles(level, [](const Node& n) { return n.box; });
+			std::uint32_t base = std::uint32_t(nodes.size());
+			nodes.insert(nodes.end(), level.begin(), level.end());
+			level = Pack(level.size(), base, false, [&](std::size_t i) { return nodes[base + i].box; });
+		}
+		nodes.push_back(level[0]);
+	}
+
+	// Shapes containing p
+	std::vector<std::uint32_t> QueryPoint(Point p) const
+	{
+		std::vector<std::uint32_t> out;
+		Search([&](const Box& b) { return Contains(b, p); },
+			   [&](std::uint32_t id) { if (Contains(*shapes[id], p)) out.push_back(id); });
+		return out;
+	}
+
+	// Shapes intersecting the window
+	std::vector<std::uint32_t> QueryWindow(const Box& window) const
+	{
+		std::vector<std::uint32_t> out;
+		PlacedRectangle rectangle = ToRectangle(window);
+		Search([&](const Box& b) { return Overlaps(b, window); },
+			   [&](std::uint32_t id) { if (Intersects(*shapes[id], rectangle)) out.push_back(id); });
+		return out;
+	}
+
+	// The k shapes closest to p, nearest first. Best-first search: a queue 
+	// ordered by distance holds nodes (by box distance) and shapes (by exact 
+	// distance, never less than their box's), so shapes come out in order.
+	std::vector<Neighbor> Nearest(Point p, std::size_t k) const
+	{
+		std::vector<Neighbor> out;
+		if (nodes.empty() || k == 0)
+			return out;
+
+		struct Entry
+		{
+			double distance;
+			std::uint32_t index;
+			bool isShape;
+
+			bool operator>(const Entry& other) const { return distance > other.distance; }
+		};
+
+		std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+		queue.push({ Distance(nodes.back().box, p), std::uint32_t(nodes.size() - 1), false });
+
+		while (!queue.empty() && out.size() < k)
+		{
+			Entry e = queue.top();
+			queue.pop();
+			if (e.isShape)
+			{
+				out.push_back({ e.index, e.distance });
+				continue;
+			}
+
+			const Node& node = nodes[e.index];
+			for (std::uint32_t i = node.first; i < node.first + node.count; i++)
+			{
+				if (node.leaf)
+					queue.push({ Distance(*shapes[order[i]], p), order[i], true });
+				else
+					queue.push({ Distance(nodes[i].box, p), i, false });
+			}
+		}
+		return out;
+	}
+};
+
+void RunSpatialIndexSample()
+{
+	const std::size_t n = 100000;
+	const std::size_t queries = 2000;
+	std::mt19937 rng(7);
+
+	// Uniform: spread over the whole square. Skewed: most shapes in a few 
+	// tight clusters.
+	std::uniform_real_distribution<double> anywhere(0, 10000), size(1, 10);
+	std::normal_distribution<double> cluster(0, 300);
+	Point centers[4] = { { 2000, 2000 }, { 2100, 2050 }, { 7000, 3000 }, { 5000, 9000 } };
+
+	auto run = [&](const char* label, bool skewed)
+	{
+		std::vector<PlacedCircle> circles;
+		std::vector<PlacedRectangle> rectangles;
+		auto position = [&]()
+		{
+			if (!skewed || rng() % 10 == 0)
+				return Point{ anywhere(rng), anywhere(rng) };
+			Point c = centers[rng() % 4];
+			return Point{ c.x + cluster(rng), c.y + cluster(rng) };
+		};
+		for (std::size_t i = 0; i < n / 2; i++)
+		{
+			circles.emplace_back(position(), size(rng));
+			rectangles.emplace_back(position(), size(rng), size(rng));
+		}
+		std::vector<const PlacedShape*> shapes;
+		for (std::size_t i = 0; i < n / 2; i++)
+		{
+			shapes.push_back(&circles[i]);
+			shapes.push_back(&rectangles[i]);
+		}
+
+		// Queries follow the data, as they would in practice
+		std::vector<Point> points;
+		for (std::size_t q = 0; q < queries; q++)
+			points.push_back(position());
+
+		auto time = [&](const char* name, auto&& body)
+		{
+			auto start = std::chrono::steady_clock::now();
+			std::size_t results = 0;
+			for (Point p : points)
+				results += body(p);
+			std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+			std::cout << "  " << name << elapsed.count() * 1e6 / queries << " us/query (" << results << ")" << std::endl;
+		};
+
+		auto window = [](Point p) { return Box{ p, { p.x + 50, p.y + 50 } }; };
+
+		std::cout << label << std::endl;
+		time("scan  window : ", [&](Point p)
+		{
+			PlacedRectangle rectangle = ToRectangle(window(p));
+			std::size_t hits = 0;
+			for (const PlacedShape* shape : shapes)
+				hits += Intersects(*shape, rectangle);
+			return hits;
+		});
+
+		auto start = std::chrono::steady_clock::now();
+		UniformGrid grid(shapes);
+		RTree tree(shapes);
+		std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+		std::cout << "  grid + tree built in " << built.count() * 1e3 << " ms" << std::endl;
+
+		time("grid  window : ", [&](Point p) { return grid.QueryWindow(window(p)).size(); });
+		time("rtree window : ", [&](Point p) { return tree.QueryWindow(window(p)).size(); });
+		time("grid  point  : ", [&](Point p) { return grid.QueryPoint(p).size(); });
+		time("rtree point  : ", [&](Point p) { return tree.QueryPoint(p).size(); });
+		time("grid  10-NN  : ", [&](Point p) { return grid.Nearest(p, 10).size(); });
+		time("rtree 10-NN  : ", [&](Point p) { return tree.Nearest(p, 10).size(); });
+	};
+
+	run("uniform shapes:", false);
+	run("skewed shapes:", true);
+}
+
+/*
+	================================
+	|                              |
+	|   INCREMENTAL AGGREGATES     |
+	|                              |
+	================================
+
+	Reporting the total, smallest and largest area of a collection by calling 
+	calculateArea() on every shape costs O(n) per report, even when almost 
+	nothing has changed since the last one.
+
+	ShapeCollection owns its shapes and only lets them change through 
+	Modify(), which sees the area before and after the change. It keeps:
+	- the total area as a compensated running sum (O(1) per change),
+	- every area in a multiset, whose ends are the min and max (O(log n)),
+	- a count per concrete type (O(1)).
+	Every report is then O(1).
+
+	A Handle is a slot index plus the generation of that slot. Removing a 
+	shape bumps the generation, so a handle kept after Remove() no longer 
+	matches once the slot is reused, and is rejected rather than reaching
+	the new shape.
+*/
+
+// Running sum with Neumaier compensation, so that many additions and 
+// subtractions of areas do not drift away from the exact total
+class CompensatedSum
+{
+private:
+
+	double sum = 0;
+	double compensation = 0;
+
+public:
+
+	void Add(double x)
+	{
+		double t = sum + x;
+		if (std::abs(sum) >= std::abs(x))
+			compensation += (sum - t) + x;
+		else
+			compensation += (x - t) + sum;
+		sum = t;
+	}
+
+	double Value() const { return sum + compensation; }
+};
+
+class ShapeCollection
+{
+public:
+
+	struct Handle
+	{
+		std::uint32_t index;
+		std::uint32_t generation;
+	};
+
+private:
+
+	struct Slot
+	{
+		std::unique_ptr<Shape> shape;
+		std::multiset<double>::iterator area;
+		std::uint32_t generation = 0;
+	};
+
+	std::vector<Slot> slots;
+	std::vector<std::uint32_t> freeSlots;
+	std::multiset<double> areas;
+	std::unordered_map<std::type_index, std::size_t> counts;
+	CompensatedSum total;
+
+	// The slot of a shape that is still in the collection
+	const Slot& Live(Handle h) const
+	{
+		if (h.index >= slots.size() || slots[h.index].generation != h.generation || !slots[h.index].shape)
+			throw std::out_of_range("ShapeCollection: invalid or removed handle");
+		return slots[h.index];
+	}
+
+	Slot& Live(Handle h)
+	{
+		return const_cast<Slot&>(std::as_const(*this).Live(h));
+	}
+
+public:
+
+	template <typename S, typename... Args>
+	Handle Add(Args&&... args)
+	{
+		std::uint32_t index;
+		if (freeSlots.empty())
+		{
+			index = std::uint32_t(slots.size());
+			slots.emplace_back();
+		}
+		else
+		{
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+
+		Slot& slot = slots[index];
+		slot.shape = std::make_unique<S>(std::forward<Args>(args)...);
+		double area = slot.shape->calculateArea();
+		slot.area = areas.insert(area);
+		total.Add(area);
+		counts[typeid(S)]++;
+		return Handle{ index, slot.generation };
+	}
+
+	void Remove(Handle h)
+	{
+		Slot& slot = Live(h);
+		total.Add(-*slot.area);
+		areas.erase(slot.area);
+		counts[typeid(*slot.shape)]--;
+		slot.shape.reset();
+		slot.generation++;
+		freeSlots.push_back(h.index);
+	}
+
+	// Applies change to the shape, which must be an S, and updates the aggregates
+	template <typename S, typename F>
+	void Modify(Handle h, F&& change)
+	{
+		Slot& slot = Live(h);
+		S& shape = dynamic_cast<S&>(*slot.shape);
+		change(shape);
+
+		// Two separate terms: rounding area - old before adding it would 
+		// lose exactly the error the compensation is there to keep
+		double area = shape.calculateArea();
+		total.Add(area);
+		total.Add(-*slot.area);
+
+		// Reuse the multiset node rather than freeing and allocating one
+		auto node = areas.extract(slot.area);
+		node.value() = area;
+		slot.area = areas.insert(std::move(node));
+	}
+
+	const Shape& Get(Handle h) const { return *Live(h).shape; }
+
+	std::size_t Size() const { return areas.size(); }
+	double TotalArea() const { return total.Value(); }
+	double MinArea() const { return areas.empty() ? 0 : *areas.begin(); }
+	double MaxArea() const { return areas.empty() ? 0 : *areas.rbegin(); }
+
+	template <typename S>
+	std::size_t Count() const
+	{
+		auto it = counts.find(typeid(S));
+		return it == counts.end() ? 0 : it->second;
+	}
+};
+
+void RunAggregateSample()
+{
+	const std::size_t n = 100000;
+	const int polls = 1000;
+	const int changesPerPoll = 10;
+	std::mt19937 rng(11);
+	std::uniform_real_distribution<double> size(1, 10), factor(0.9, 1.1);
+
+	ShapeCollection collection;
+	std::vector<ShapeCollection::Handle> circles, rectangles;
+	for (std::size_t i = 0; i < n / 2; i++)
+	{
+		circles.push_back(collection.Add<Circle>(size(rng)));
+		rectangles.push_back(collection.Add<Rectangle>(size(rng), size(rng)));
+	}
+
+	auto change = [&]()
+	{
+		std::size_t i = rng() % (n / 2);
+		if (rng() % 2)
+			collection.Modify<Circle>(circles[i], [&](Circle& c) { c.scale(factor(rng)); });
+		else
+			collection.Modify<Rectangle>(rectangles[i], [&](Rectangle& r) { r.resize(size(rng), size(rng)); });
+	};
+
+	// Recomputing everything on each poll
+	auto start = std::chrono::steady_clock::now();
+	double checksum = 0;
+	for (int p = 0; p < polls; p++)
+	{
+		for (int c = 0; c < changesPerPoll; c++)
+			change();
+
+		double total = 0, smallest = 1e300, largest = 0;
+		for (const auto* handles : { &circles, &rectangles })
+		{
+			for (ShapeCollection::Handle h : *handles)
+			{
+				double area = collection.Get(h).calculateArea();
+				total += area;
+				smallest = std::min(smallest, area);
+				largest = std::max(largest, area);
+			}
+		}
+		checksum += total + smallest + largest;
+	}
+	std::chrono::duration<double> recompute = std::chrono::steady_clock::now() - start;
+
+	// Reading the maintained aggregates
+	start = std::chrono::steady_clock::now();
+	double incrementalChecksum = 0;
+	for (int p = 0; p < polls; p++)
+	{
+		for (int c = 0; c < changesPerPoll; c++)
+			change();
+		incrementalChecksum += collection.TotalArea() + collection.MinArea() + collection.MaxArea();
+	}
+	std::chrono::duration<double> incremental = std::chrono::steady_clock::now() - start;
+
+	std::cout << "shapes: " << collection.Size() << " (" << collection.Count<Circle>() << " circles, "
+			  << collection.Count<Rectangle>() << " rectangles)" << std::endl;
+	std::cout << "total area: " << collection.TotalArea() << ", min: " << collection.MinArea()
+			  << ", max: " << collection.MaxArea() << std::endl;
+	std::cout << "recompute  : " << recompute.count() * 1e6 / polls << " us/poll (" << checksum << ")" << std::endl;
+	std::cout << "incremental: " << incremental.count() * 1e6 / polls << " us/poll (" << incrementalChecksum << ")" << std::endl;
+}
+
+/*
+	================================
+	|                              |
+	|     LOADING SHAPES FROM      |
+	|           TEXT               |
+	|                              |
+	================================
+
+	Shapes are described one per line:
+
+		circle 5
+		rectangle 4 6
+
+	ParseShapes cuts the text into one chunk per thread, moving every cut 
+	forward to just after a newline so no line is split, parses the chunks 
+	concurrently with std::from_chars (no locale, no allocation per number), 
+	and appends the per-chunk results, so the shapes keep their file order.
+
+	LoadShapes reads a whole file first. LoadShapesStreaming reads a fixed 
+	size block at a time instead, carrying any unfinished last line over to 
+	the next block, and hands each block's shapes to a callback, so memory 
+	stays bounded however large the file is.
+
+	A malformed line, or a dimension that is negative, infinite or NaN, 
+	throws std::runtime_error naming its line number.
+*/
+
+// A parsed shape, stored by value
+using ParsedShape = std::variant<Circle, Rectangle>;
+
+inline const Shape& AsShape(const ParsedShape& shape)
+{
+	return std::visit([](const auto& s) -> const Shape& { return s; }, shape);
+}
+
+struct LoadedShapes
+{
+	std::vector<ParsedShape> shapes;    // in file order
+	std::size_t lines = 0;
+
+	void Append(LoadedShapes&& other)
+	{
+		// Taking over the other vector is cheaper than moving every shape
+		if (shapes.empty() && shapes.capacity() < other.shapes.size())
+			shapes = std::move(other.shapes);
+		else
+			shapes.insert(shapes.end(), std::make_move_iterator(other.shapes.begin()), std::make_move_iterator(other.shapes.end()));
+		lines += other.lines;
+	}
+};
+
+const char* SkipSpaces(const char* p, const char* end)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		p++;
+	return p;
+}
+
+// A length: finite and not negative
+bool ParseDimension(const char*& p, const char* end, double& value)
+{
+	p = SkipSpaces(p, end);
+	auto [next, ec] = std::from_chars(p, end, value);
+	p = next;
+	return ec == std::errc() && std::isfinite(value) && value >= 0;
+}
+
+// One line without its newline; blank lines are allowed
+bool ParseShapeLine(const char* p, const char* end, LoadedShapes& out)
+{
+	p = SkipSpaces(p, end);
+	const char* word = p;
+	while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+		p++;
+	std::string_view kind(word, p - word);
+
+	double a, b;
+	if (kind.empty())
+		return true;
+	else if (kind == "circle" && ParseDimension(p, end, a))
+		out.shapes.emplace_back(std::in_place_type<Circle>, a);
+	else if (kind == "rectangle" && ParseDimension(p, end, a) && ParseDimension(p, end, b))
+		out.shapes.emplace_back(std::in_place_type<Rectangle>, a, b);
+	else
+		return false;
+
+	return SkipSpaces(p, end) == end;
+}
+
+struct ParsedChunk
+{
+	LoadedShapes shapes;
+	std::size_t errorLine = 0;      // first bad line within the chunk, 1-based; 0 if none
+	std::string errorText;
+};
+
+ParsedChunk ParseChunk(std::string_view text)
+{
+	ParsedChunk chunk;
+	const char* p = text.data();
+	const char* end = p + text.size();
+	while (p < end)
+	{
+		const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		if (!eol)
+			eol = end;
+
+		chunk.shapes.lines++;
+		if (!ParseShapeLine(p, eol, chunk.shapes) && chunk.errorLine == 0)
+		{
+			chunk.errorLine = chunk.shapes.lines;
+			chunk.errorText.assign(p, eol > p && eol[-1] == '\r' ? eol - 1 : eol);
+		}
+		p = eol == end ? end : eol + 1;
+	}
+	return chunk;
+}
+
+// lineOffset is the number of lines before text, for error messages
+LoadedShapes ParseShapes(std::string_view text, unsigned threads = std::thread::hardware_concurrency(),
+						 std::size_t lineOffset = 0)
+{
+	// Small inputs are not worth a thread
+	const std::size_t minChunk = 64 * 1024;
+	threads = unsigned(std::clamp<std::size_t>(text.size() / minChunk, 1, std::max(threads, 1u)));
+
+	std::vector<std::size_t> cuts{ 0 };
+	for (unsigned t = 1; t < threads; t++)
+	{
+		std::size_t newline = text.find('\n', std::max(text.size() * t / threads, cuts.back()));
+		cuts.push_back(newline == std::string_view::npos ? text.size() : newline + 1);
+	}
+	cuts.push_back(text.size());
+
+	std::vector<ParsedChunk> chunks(threads);
+	auto parse = [&](unsigned t) { chunks[t] = ParseChunk(text.substr(cuts[t], cuts[t + 1] - cuts[t])); };
+
+	std::vector<std::thread> workers;
+	for (unsigned t = 1; t < threads; t++)
+		workers.emplace_back(parse, t);
+	parse(0);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	LoadedShapes out;
+	if (chunks.size() > 1)
+	{
+		std::size_t count = 0;
+		for (const ParsedChunk& chunk : chunks)
+			count += chunk.shapes.shapes.size();
+		out.shapes.reserve(count);
+	}
+
+	// Chunks are in file order, so the first error found is the earliest
+	for (ParsedChunk& chunk : chunks)
+	{
+		if (chunk.errorLine != 0)
+		{
+			std::size_t line = lineOffset + out.lines + chunk.errorLine;
+			throw std::runtime_error("line " + std::to_string(line) + ": bad shape \"" + chunk.errorText + "\"");
+		}
+		out.Append(std::move(chunk.shapes));
+	}
+	return out;
+}
+
+LoadedShapes LoadShapes(const std::filesystem::path& path, unsigned threads = std::thread::hardware_concurrency())
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		throw std::runtime_error("cannot open " + path.string());
+
+	std::string text(std::filesystem::file_size(path), '\0');
+	in.read(text.data(), text.size());
+	text.resize(in.gcount());
+	return ParseShapes(text, threads);
+}
+
+// Calls consume(LoadedShapes&&) once per block; returns the number of lines
+template <typename Consume>
+std::size_t LoadShapesStreaming(const std::filesystem::path& path, Consume&& consume,
+								std::size_t blockSize = 16 << 20,
+								unsigned threads = std::thread::hardware_concurrency())
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		throw std::runtime_error("cannot open " + path.string());
+
+	std::string buffer(std::max<std::size_t>(blockSize, 1), '\0');
+	std::size_t kept = 0;       // start of a line carried over from the last block
+	std::size_t lines = 0;
+	for (;;)
+	{
+		in.read(buffer.data() + kept, buffer.size() - kept);
+		std::size_t size = kept + in.gcount();
+		bool last = size < buffer.size();
+
+		std::string_view block(buffer.data(), size);
+		std::size_t cut = size;
+		if (!last)
+		{
+			std::size_t newline = block.rfind('\n');
+			if (newline == std::string_view::npos)
+			{
+				// One line longer than the block: grow and read on
+				kept = size;
+				buffer.resize(buffer.size() * 2);
+				continue;
+			}
+			cut = newline + 1;
+		}
+
+		LoadedShapes shapes = ParseShapes(block.substr(0, cut), threads, lines);
+		lines += shapes.lines;
+		consume(std::move(shapes));
+
+		kept = size - cut;
+		std::memmove(buffer.data(), buffer.data() + cut, kept);
+		if (last)
+			return lines;
+	}
+}
+
+void RunLoaderSample()
+{
+	for (const ParsedShape& shape : ParseShapes("circle 5\nrectangle 4 6\n").shapes)
+		std::cout << AsShape(shape).calculateArea() << std::endl;
+
+	for (const char* text : { "circle 5\ntriangle 3 4 5\n", "rectangle 4 6\ncircle -5\n" })
+	{
+		try
+		{
+			ParseShapes(text);
+		}
+		catch (const std::runtime_error& e)
+		{
+			std::cout << "Error: " << e.what() << std::endl;
+		}
+	}
+
+	// A sample file of a million shapes
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "shapes_sample.txt";
+	{
+		std::ofstream out(path, std::ios::binary);
+		std::mt19937 rng(13);
+		for (int i = 0; i < 1000000; i++)
+		{
+			if (rng() % 2)
+				out << "circle " << 1 + rng() % 1000 / 100.0 << '\n';
+			else
+				out << "rectangle " << 1 + rng() % 100 << ' ' << 1 + rng() % 1000 / 10.0 << '\n';
+		}
+	}
+
+	auto area = [](const LoadedShapes& shapes)
+	{
+		double total = 0;
+		for (const ParsedShape& shape : shapes.shapes)
+			total += AsShape(shape).calculateArea();
+		return total;
+	};
+
+	auto time = [&](const char* label, auto&& body)
+	{
+		auto start = std::chrono::steady_clock::now();
+		double total = body();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		std::cout << label << elapsed.count() * 1e3 << " ms (area " << total << ")" << std::endl;
+	};
+
+	time("iostream      : ", [&]
+	{
+		LoadedShapes shapes;
+		std::ifstream in(path);
+		std::string kind;
+		double a, b;
+		while (in >> kind)
+		{
+			if (kind == "circle" && in >> a)
+				shapes.shapes.emplace_back(std::in_place_type<Circle>, a);
+			else if (kind == "rectangle" && in >> a >> b)
+				shapes.shapes.emplace_back(std::in_place_type<Rectangle>, a, b);
+		}
+		return area(shapes);
+	});
+	time("LoadShapes    : ", [&] { return area(LoadShapes(path)); });
+	time("streaming 1MiB: ", [&]
+	{
+		double total = 0;
+		LoadShapesStreaming(path, [&](LoadedShapes&& shapes) { total += area(shapes); }, 1 << 20);
+		return total;
+	});
+
+	std::filesystem::remove(path);
+}
+
+/*
+	================================
+	|                              |
+	|     LAZY GENERATORS          |
+	|                              |
+	================================
+
+	A generator<T> is a C++20 coroutine that produces values one at a time 
+	with co_yield. Nothing runs until the consumer asks for the next value, 
+	and the coroutine keeps only its own local state between values. A 
+	pipeline of generators can therefore stream a file, or an endless 
+	computation, without ever building the full collection:
+
+		for (std::span<const double> areas : batch(transform(ReadShapes(path), area), 4096))
+			...
+
+	The adaptors are generators themselves:
+	- filter(source, pred)  : only the values for which pred is true
+	- transform(source, f)  : f applied to every value
+	- take(source, n)       : the first n values, then stops pulling
+	- batch(source, size)   : copies of consecutive values, size at a time
+
+	T may be a reference (e.g. generator<const Shape&>): the value is then 
+	not copied, and stays valid until the consumer asks for the next one.
+*/
+
+template <typename T>
+class generator
+{
+public:
+
+	using value_type = std::remove_cvref_t<T>;
+	using reference = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+	struct promise_type
+	{
+		// Points at the operand of the last co_yield, which lives on until 
+		// the coroutine is resumed
+		std::add_pointer_t<reference> current = nullptr;
+		std::exception_ptr exception;
+
+		generator get_return_object()
+		{
+			return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+		}
+
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+
+		std::suspend_always yield_value(reference value) noexcept
+		{
+			current = std::addressof(value);
+			return {};
+		}
+
+		void return_void() {}
+		void unhandled_exception() { exception = std::current_exception(); }
+
+		// Prevents co_await inside a generator: any awaited operand picks 
+		// this deleted overload
+		template <typename U>
+		void await_transform(U&&) = delete;
+
+		void Rethrow()
+		{
+			if (exception)
+				std::rethrow_exception(std::exchange(exception, nullptr));
+		}
+	};
+
+	class iterator
+	{
+	private:
+
+		std::coroutine_handle<promise_type> handle;
+
+	public:
+
+		using value_type = generator::value_type;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		explicit iterator(std::coroutine_handle<promise_type> h) : handle(h)
+		{}
+
+		reference operator*() const { return *handle.promise().current; }
+
+		iterator& operator++()
+		{
+			handle.resume();
+			handle.promise().Rethrow();
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) { return it.handle.done(); }
+	};
+
+private:
+
+	std::coroutine_handle<promise_type> handle;
+	bool started = false;
+
+	explicit generator(std::coroutine_handle<promise_type> h) : handle(h)
+	{}
+
+public:
+
+	generator(generator&& other) noexcept
+		: handle(std::exchange(other.handle, nullptr)), started(std::exchange(other.started, false))
+	{}
+
+	generator& operator=(generator other) noexcept
+	{
+		std::swap(handle, other.handle);
+		std::swap(started, other.started);
+		return *this;
+	}
+
+	~generator()
+	{
+		if (handle)
+			handle.destroy();
+	}
+
+	// Runs the coroutine up to its first co_yield. A generator is a single 
+	// pass: a second call would resume a coroutine that has already run, so 
+	// it throws std::logic_error instead
+	iterator begin()
+	{
+		if (started)
+			throw std::logic_error("generator: begin() called more than once");
+		started = true;
+		handle.resume();
+		handle.promise().Rethrow();
+		return iterator(handle);
+	}
+
+	std::default_sentinel_t end() const { return {}; }
+};
+
+// Adaptors take their source and function by value: a coroutine must not 
+// keep references to arguments that may be temporaries.
+
+template <typename T, typename Pred>
+generator<T> filter(generator<T> source, Pred pred)
+{
+	for (auto&& value : source)
+	{
+		if (std::invoke(pred, value))
+			co_yield value;
+	}
+}
+
+template <typename T, typename F>
+auto transform(generator<T> source, F f) -> generator<std::invoke_result_t<F&, typename generator<T>::reference>>
+{
+	for (auto&& value : source)
+		co_yield std::invoke(f, value);
+}
+
+template <typename T>
+generator<T> take(generator<T> source, std::size_t n)
+{
+	if (n == 0)
+		co_return;
+	for (auto&& value : source)
+	{
+		co_yield value;
+		if (--n == 0)
+			co_return;      // without pulling one more value from source
+	}
+}
+
+// The last batch may be shorter; each span is valid until the next one
+template <typename T, typename V = typename generator<T>::value_type>
+	requires std::copy_constructible<V>
+generator<std::span<const V>> batch(generator<T> source, std::size_t size)
+{
+	std::vector<V> items;
+	items.reserve(size);
+	for (auto&& value : source)
+	{
+		items.push_back(value);
+		if (items.size() == size)
+		{
+			co_yield std::span<const V>(items);
+			items.clear();
+		}
+	}
+	if (!items.empty())
+		co_yield std::span<const V>(items);
+}
+
+// An endless computed source
+generator<Circle> Circles(double radius, double step)
+{
+	for (;;)
+	{
+		co_yield Circle(radius);
+		radius += step;
+	}
+}
+
+// A file source: one line in memory at a time
+generator<const Shape&> ReadShapes(std::filesystem::path path)
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+		throw std::runtime_error("cannot open " + path.string());
+
+	LoadedShapes shape;
+	std::string line;
+	for (std::size_t number = 1; std::getline(in, line); number++)
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+
+		shape.shapes.clear();
+		if (!ParseShapeLine(line.data(), line.data() + line.size(), shape))
+			throw std::runtime_error("line " + std::to_string(number) + ": bad shape \"" + line + "\"");
+
+		if (!shape.shapes.empty())
+			co_yield AsShape(shape.shapes.back());
+	}
+}
+
+void RunGeneratorSample()
+{
+	// The first three circles with an area over 100, from an endless source
+	auto large = [](const Circle& c) { return c.calculateArea() > 100; };
+	for (const Circle& circle : take(filter(Circles(1, 0.5), large), 3))
+		std::cout << "Area of Circle: " << circle.calculateArea() << std::endl;
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "shapes_generator.txt";
+	{
+		std::ofstream out(path, std::ios::binary);
+		std::mt19937 rng(17);
+		for (int i = 0; i < 1000000; i++)
+		{
+			if (rng() % 2)
+				out << "circle " << 1 + rng() % 1000 / 100.0 << '\n';
+			else
+				out << "rectangle " << 1 + rng() % 100 << ' ' << 1 + rng() % 1000 / 10.0 << '\n';
+		}
+	}
+
+	// Streams a million shapes through a pipeline, 4096 areas at a time
+	auto area = [](const Shape& s) { return s.calculateArea(); };
+	auto start = std::chrono::steady_clock::now();
+	double total = 0;
+	std::size_t batches = 0;
+	for (std::span<const double> areas : batch(transform(ReadShapes(path), area), 4096))
+	{
+		for (double a : areas)
+			total += a;
+		batches++;
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << "generator pipeline: " << elapsed.count() * 1e3 << " ms, " << batches << " batches (area " << total << ")" << std::endl;
+
+	std::filesystem::remove(path);
+}
+
+int main() {
+
+	// Shape shape; // Error: Cannot create instance of an abstract class
+
+	Circle circle(5);
+	Rectangle rectangle(4, 6);
+
+	circle.display();
+	std::cout << "Area of Circle: " << circle.calculateArea() << std::endl;
+
+	rectangle.display();
+	std::cout << "Area of Rectangle: " << rectangle.calculateArea() << std::endl;
+
+	RunStaticSample();
+	RunPrecisionSample();
+	RunIntersectionSample();
+	RunSpatialIndexSample();
+	RunAggregateSample();
+	RunLoaderSample();
+	RunGeneratorSample();
 
 	return 0;
 }
@@ -1,4 +1,18 @@
 #include <iostream>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cmath>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
 
 /*
 	================================
@@ -71,6 +85,376 @@ double divide(double dividend, double divisor)
 	return dividend / divisor;
 }
 
+/*
+	================================
+	|                              |
+	|   ERRORS AS RETURN VALUES    |
+	|                              |
+	================================
+
+	Instead of throwing, a function can return either its result or an error. 
+	std::expected<T, E> (C++23) holds exactly one of the two, and the caller 
+	checks it like a pointer:
+
+	auto result = try_divide(a, b);
+	if (result)
+		use(*result);
+	else
+		handle(result.error());
+
+	The error is a typed enum, so it can be switched on, and nothing is 
+	unwound: a failure costs about as much as a success.
+*/
+
+enum class DivideError { DivisionByZero, InvalidOperand };
+
+std::expected<double, DivideError> try_divide(double dividend, double divisor)
+{
+	if (std::isnan(dividend) || std::isnan(divisor))
+		return std::unexpected(DivideError::InvalidOperand);
+	if (divisor == 0)
+		return std::unexpected(DivideError::DivisionByZero);
+	return dividend / divisor;
+}
+
+const char* ToString(DivideError error)
+{
+	switch (error)
+	{
+	case DivideError::DivisionByZero: return "Division by zero error";
+	case DivideError::InvalidOperand: return "Invalid operand";
+	}
+	return "Unknown error";
+}
+
+/*
+	================================
+	|                              |
+	|   BATCH ERRORS WITHOUT THROW |
+	|                              |
+	================================
+
+	Throwing is cheap when nothing goes wrong, but every throw that happens 
+	costs microseconds (the stack is unwound and the handler searched for). 
+	Calling divide() inside a try block for each row of a large table turns a 
+	small error rate into a large slowdown, and one bad row stops the rest.
+
+	The batch overload of divide() below never throws for a zero divisor:
+	- all rows are divided in one branch-free loop (4 at a time with AVX),
+	- the rows that failed are returned as a bitmask (one bit per row), which
+	  can be turned into a list of indices when needed,
+	- DividePolicy decides what is written for a failed row:
+	    Ieee     : the IEEE result, +/-inf or NaN
+	    Sentinel : a caller supplied value
+	    Skip     : nothing, the output keeps its previous value
+
+	Exceptions are still used for real programming errors, such as spans of
+	different lengths.
+*/
+
+enum class DividePolicy { Ieee, Sentinel, Skip };
+
+struct DivideErrors
+{
+	std::vector<std::uint64_t> mask;	// bit i set when row i failed
+	std::size_t count = 0;
+
+	bool Failed(std::size_t row) const
+	{
+		return (mask[row / 64] >> (row % 64)) & 1;
+	}
+
+	std::vector<std::size_t> Indices() const
+	{
+		std::vector<std::size_t> rows;
+		rows.reserve(count);
+		for (std::size_t w = 0; w < mask.size(); w++)
+		{
+			for (std::uint64_t bits = mask[w]; bits != 0; bits &= bits - 1)
+				rows.push_back(w * 64 + std::countr_zero(bits));
+		}
+		return rows;
+	}
+};
+
+DivideErrors divide(std::span<const double> dividends, std::span<const double> divisors, 
+                    std::span<double> out, DividePolicy policy = DividePolicy::Ieee, double sentinel = 0)
+{
+	const std::size_t n = out.size();
+	if (dividends.size() != n || divisors.size() != n)
+		throw std::invalid_argument("divide: spans must have the same length");
+
+	DivideErrors errors;
+	errors.mask.assign((n + 63) / 64, 0);
+
+	// Rows that failed keep the old output under Skip
+	auto select = [&](double quotient, bool zero, double previous)
+	{
+		double replacement = (policy == DividePolicy::Sentinel) ? sentinel : previous;
+		return (zero && policy != DividePolicy::Ieee) ? replacement : quotient;
+	};
+
+	for (std::size_t w = 0; w < errors.mask.size(); w++)
+	{
+		const std::size_t begin = w * 64;
+		const std::size_t end = std::min(n, begin + 64);
+		std::uint64_t bits = 0;
+		std::size_t i = begin;
+
+#if defined(__AVX__)
+		const __m256d zero = _mm256_setzero_pd();
+		const __m256d fill = _mm256_set1_pd(sentinel);
+		for (; i + 4 <= end; i += 4)
+		{
+			__m256d a = _mm256_loadu_pd(dividends.data() + i);
+			__m256d b = _mm256_loadu_pd(divisors.data() + i);
+			__m256d q = _mm256_div_pd(a, b);
+			__m256d failed = _mm256_cmp_pd(b, zero, _CMP_EQ_OQ);
+
+			if (policy == DividePolicy::Sentinel)
+				q = _mm256_blendv_pd(q, fill, failed);
+			else if (policy == DividePolicy::Skip)
+				q = _mm256_blendv_pd(q, _mm256_loadu_pd(out.data() + i), failed);
+
+			_mm256_storeu_pd(out.data() + i, q);
+			bits |= (std::uint64_t)_mm256_movemask_pd(failed) << (i - begin);
+		}
+#endif
+
+		for (; i < end; i++)
+		{
+			bool failed = divisors[i] == 0;
+			out[i] = select(dividends[i] / divisors[i], failed, out[i]);
+			bits |= (std::uint64_t)failed << (i - begin);
+		}
+
+		errors.mask[w] = bits;
+		errors.count += std::popcount(bits);
+	}
+	return errors;
+}
+
+void RunBatchSample()
+{
+	std::vector<double> dividends = { 10, 20, 30, 40, 50, 60 };
+	std::vector<double> divisors = { 2, 0, 5, 0, 10, 3 };
+	std::vector<double> out(dividends.size(), -1);
+
+	DivideErrors errors = divide(dividends, divisors, out, DividePolicy::Sentinel, 0);
+	std::cout << "Results:";
+	for (double v : out)
+		std::cout << " " << v;
+	std::cout << std::endl << "Failed rows:";
+	for (std::size_t row : errors.Indices())
+		std::cout << " " << row;
+	std::cout << std::endl;
+
+	// 1% zero divisors: try/catch per row vs one batch call
+	const std::size_t n = 1 << 20;
+	std::vector<double> a(n, 1.0), b(n, 2.0), q(n);
+	for (std::size_t i = 0; i < n; i += 100)
+		b[i] = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	std::size_t failures = 0;
+	for (std::size_t i = 0; i < n; i++)
+	{
+		try
+		{
+			q[i] = divide(a[i], b[i]);
+		}
+		catch (const char*)
+		{
+			q[i] = 0;
+			failures++;
+		}
+	}
+	std::chrono::duration<double> perRow = std::chrono::steady_clock::now() - start;
+
+	start = std::chrono::steady_clock::now();
+	errors = divide(a, b, q, DividePolicy::Sentinel, 0);
+	std::chrono::duration<double> batch = std::chrono::steady_clock::now() - start;
+
+	std::cout << "try/catch per row: " << perRow.count() * 1e3 << " ms, " << failures << " errors" << std::endl;
+	std::cout << "batch divide     : " << batch.count() * 1e3 << " ms, " << errors.count << " errors" << std::endl;
+}
+
+/*
+	================================
+	|                              |
+	|     ERROR HANDLING COSTS     |
+	|                              |
+	================================
+
+	Four ways to report the same division error, each called through a chain 
+	of `Depth` functions that just pass the result (or error) up:
+	- throw const char*
+	- throw std::runtime_error
+	- std::errc return code with an output parameter (std::errc{} is success)
+	- std::expected
+
+	For each strategy, error rate and call depth the benchmark prints the 
+	average cost of one call in nanoseconds. Exceptions cost nothing extra on 
+	the happy path but each throw is expensive and grows with depth; codes and 
+	expected pay a small check at every level, whether or not errors occur.
+*/
+
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE
+#endif
+
+double divide_runtime_error(double dividend, double divisor)
+{
+	if (divisor == 0)
+		throw std::runtime_error("Division by zero error");
+	return dividend / divisor;
+}
+
+std::errc divide_code(double dividend, double divisor, double& result)
+{
+	if (divisor == 0)
+		return std::errc::argument_out_of_domain;
+	result = dividend / divisor;
+	return std::errc{};
+}
+
+template <int Depth>
+NOINLINE double ChainThrowChar(double a, double b)
+{
+	if constexpr (Depth <= 1)
+		return divide(a, b);
+	else
+		return ChainThrowChar<Depth - 1>(a, b) + 0.0;
+}
+
+template <int Depth>
+NOINLINE double ChainThrowRuntime(double a, double b)
+{
+	if constexpr (Depth <= 1)
+		return divide_runtime_error(a, b);
+	else
+		return ChainThrowRuntime<Depth - 1>(a, b) + 0.0;
+}
+
+template <int Depth>
+NOINLINE std::errc ChainCode(double a, double b, double& result)
+{
+	if constexpr (Depth <= 1)
+		return divide_code(a, b, result);
+	else
+	{
+		if (std::errc error = ChainCode<Depth - 1>(a, b, result); error != std::errc{})
+			return error;
+		result += 0.0;
+		return std::errc{};
+	}
+}
+
+template <int Depth>
+NOINLINE std::expected<double, DivideError> ChainExpected(double a, double b)
+{
+	if constexpr (Depth <= 1)
+		return try_divide(a, b);
+	else
+	{
+		std::expected<double, DivideError> result = ChainExpected<Depth - 1>(a, b);
+		if (!result)
+			return result;
+		return *result + 0.0;
+	}
+}
+
+// Divisors where roughly `rate` of the entries are zero
+std::vector<double> MakeDivisors(std::size_t n, double rate)
+{
+	std::vector<double> divisors(n);
+	std::uint32_t state = 12345;
+	for (double& d : divisors)
+	{
+		state = state * 1664525u + 1013904223u;
+		d = (state >> 8) < rate * (1u << 24) ? 0.0 : 2.0;
+	}
+	return divisors;
+}
+
+template <int Depth>
+void BenchmarkDepth(const std::vector<double>& divisors, double rate)
+{
+	using Clock = std::chrono::steady_clock;
+	const double n = (double)divisors.size();
+	double total = 0;
+	std::size_t errors = 0;
+
+	auto start = Clock::now();
+	for (double d : divisors)
+	{
+		try { total += ChainThrowChar<Depth>(1.0, d); }
+		catch (const char*) { errors++; }
+	}
+	std::chrono::duration<double> throwChar = Clock::now() - start;
+
+	start = Clock::now();
+	for (double d : divisors)
+	{
+		try { total += ChainThrowRuntime<Depth>(1.0, d); }
+		catch (const std::runtime_error&) { errors++; }
+	}
+	std::chrono::duration<double> throwRuntime = Clock::now() - start;
+
+	start = Clock::now();
+	for (double d : divisors)
+	{
+		double result;
+		if (ChainCode<Depth>(1.0, d, result) != std::errc{})
+			errors++;
+		else
+			total += result;
+	}
+	std::chrono::duration<double> code = Clock::now() - start;
+
+	start = Clock::now();
+	for (double d : divisors)
+	{
+		std::expected<double, DivideError> result = ChainExpected<Depth>(1.0, d);
+		if (result)
+			total += *result;
+		else
+			errors++;
+	}
+	std::chrono::duration<double> expected = Clock::now() - start;
+
+	std::cout << rate * 100 << "%\t" << Depth << "\t"
+	          << throwChar.count() * 1e9 / n << "\t\t"
+	          << throwRuntime.count() * 1e9 / n << "\t\t"
+	          << code.count() * 1e9 / n << "\t"
+	          << expected.count() * 1e9 / n 
+	          << "\t(" << errors / 4 << " errors, checksum " << total << ")" << std::endl;
+}
+
+void RunBenchmarkSuite()
+{
+	auto result = try_divide(10, 0);
+	if (!result)
+		std::cout << "try_divide: " << ToString(result.error()) << std::endl;
+
+	const std::size_t calls = 100000;
+
+	std::cout.precision(3);
+	std::cout << "Errors\tDepth\tthrow char*\truntime_error\tcode\texpected   (ns/call)" << std::endl;
+	for (double rate : { 0.0, 0.01, 0.1, 0.5 })
+	{
+		std::vector<double> divisors = MakeDivisors(calls, rate);
+		BenchmarkDepth<1>(divisors, rate);
+		BenchmarkDepth<8>(divisors, rate);
+		BenchmarkDepth<16>(divisors, rate);
+	}
+	std::cout.precision(6);
+}
+
 int main()
 {
 	double a = 10, b = 0;
@@ -84,5 +468,9 @@ int main()
 		std::cerr << "Error: " << error << std::endl;
 	}
 
+	RunBatchSample();
+
+	RunBenchmarkSuite();
+
 	return 0;
 }